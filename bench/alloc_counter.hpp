@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Contador de reservas de memoria para comprobar que el camino de captura no reserva en
+// régimen estable. Cuenta las llamadas a operator new (reemplazado en alloc_counter.cpp,
+// solo en el binario de benchmarks) y las reservas de datos de cv::Mat, que OpenCV hace
+// con su propio asignador y no pasan por operator new.
+namespace alloc_counter {
+
+// Instala el asignador contador como asignador por defecto de cv::Mat.
+void install();
+
+// Reservas desde el inicio del programa (operator new + datos de cv::Mat).
+std::uint64_t count();
+
+} // namespace alloc_counter
@@ -0,0 +1,1312 @@
+// Benchmarks de rendimiento (sin ventana). Se compila con `make bench`.
+//
+//   ./motion_transfer_bench [--json bench_results.json] [--frames N] [--markers N]
+//                           [--noise SIGMA] [--motion PX] [--specks N] [--threads N]
+//                           [--resolutions 640x480,1280x720,1920x1080] [--budget MS]
+//                           [--only detect|check|alloc|render|export|shm|governor|crowd|scaling]
+//
+// Los resultados se escriben como JSON para comparar versiones. Algunas secciones además
+// comprueban requisitos, y si alguna falla el programa termina con código 2:
+//   - detect: el detector sin marcadores va en tiempo real en un núcleo a 640x480.
+//   - check: la morfología y la extracción de manchas dan lo mismo que la ruta de OpenCV, y
+//     PoseFilter descarta un pico aislado, acepta un salto real y limita la extrapolación.
+//   - alloc: el camino de captura no reserva memoria después del calentamiento.
+//   - governor: cada escalón del gobernador cambia los ajustes del detector.
+//   - scaling: las poses de cada fuente llegan en orden.
+#include "alloc_counter.hpp"
+#include "animation_mixer.hpp"
+#include "blob_extractor.hpp"
+#include "color_lut.hpp"
+#include "demo_animation.hpp"
+#include "detection_governor.hpp"
+#include "label_morphology.hpp"
+#include "motion_capture.hpp"
+#include "multi_source_capture.hpp"
+#include "parallel_for.hpp"
+#include "pose_batch.hpp"
+#include "pose_detector.hpp"
+#include "pose_filter.hpp"
+#include "pose_shm_publisher.hpp"
+#include "silhouette_detector.hpp"
+#include "stick_figure.hpp"
+#include "synthetic_video.hpp"
+#include "video_exporter.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double elapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+struct BenchOptions {
+    std::vector<cv::Size> resolutions = {{640, 480}, {1280, 720}, {1920, 1080}};
+    int frames = 60;
+    int markers = 3;
+    float noise = 4.f;
+    float motion = 3.f;
+    int specks = 200;
+    unsigned threads = 0;
+    int sources = 4;        // Escalado multi-fuente: de 1 a `sources` fuentes
+    int sourceFrames = 150; // Frames de cada video de prueba
+    double budgetMs = 0.0;  // Presupuesto del gobernador; 0 = 3 veces el coste de full_frame sin carga
+    std::string jsonPath = "bench_results.json";
+    std::string only;
+};
+
+// Muestras de tiempo de una etapa (ms por frame).
+struct StageSamples {
+    std::string name;
+    std::vector<double> ms;
+
+    double median() const {
+        if (ms.empty()) return 0.0;
+        std::vector<double> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[sorted.size() / 2];
+    }
+    double min() const { return ms.empty() ? 0.0 : *std::min_element(ms.begin(), ms.end()); }
+    double percentile(double fraction) const {
+        if (ms.empty()) return 0.0;
+        std::vector<double> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(sorted.size())))];
+    }
+};
+
+struct DetectionResult {
+    cv::Size size;
+    std::vector<StageSamples> stages;
+    // Error medio del centroide en pixels (-1 si no hubo detecciones comparables):
+    // cada ruta respecto a la posición real, y la piramidal respecto a la de resolución completa.
+    // Las entradas *_joints_found son la fracción de articulaciones esperadas que se encontraron.
+    std::vector<std::pair<std::string, double>> accuracy;
+    // Comprobaciones que fallaron (detector sin marcadores fuera de tiempo real o que no
+    // encuentra las articulaciones); vacío si todo está bien.
+    std::vector<std::string> failures;
+};
+
+// Requisitos del detector sin marcadores a 640x480 en un solo núcleo.
+constexpr double kFrameBudgetMs = 1000.0 / 60.0;
+constexpr double kMinSilhouetteJointsFound = 0.8;
+
+// Acumula la distancia media entre las articulaciones presentes en dos poses.
+struct ErrorAccumulator {
+    double sum = 0.0;
+    int count = 0;
+
+    void add(sf::Vector2f a, sf::Vector2f b) {
+        sf::Vector2f d = a - b;
+        sum += std::sqrt(d.x * d.x + d.y * d.y);
+        ++count;
+    }
+    void add(const DetectedPose& a, const DetectedPose& b) {
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            if (a.confidence[j] > 0.f && b.confidence[j] > 0.f) add(a.positions[j], b.positions[j]);
+        }
+    }
+    double mean() const { return count > 0 ? sum / count : -1.0; }
+};
+
+// Extracción de manchas frente a findContours + contourArea + moments, sobre las mismas máscaras.
+struct BlobCheckResult {
+    int masks = 0;                      // Máscaras comparadas (frames x colores)
+    std::uint64_t accepted = 0;         // Manchas aceptadas por las dos rutas
+    std::uint64_t mismatches = 0;       // Manchas aceptadas por una sola ruta (debe ser 0)
+    std::uint64_t knownDifferences = 0; // Manchas con huecos o dentro de un hueco (no se comparan)
+    double maxAreaError = 0.0;          // Máximo |cv::contourArea - Blob::contourArea()|
+    double maxCentroidError = 0.0;      // Máxima distancia entre el centroide del contorno y el de los pixels
+};
+
+// LabelMorphology y BitMorphology frente a cv::erode/cv::dilate, en pixels distintos.
+struct MorphologyCheckResult {
+    int masks = 0;                     // Máscaras comparadas (frames x anchos)
+    std::uint64_t byteMismatches = 0;  // LabelMorphology (debe ser 0)
+    std::uint64_t bitMismatches = 0;   // BitMorphology (debe ser 0)
+    std::uint64_t paddingViolations = 0; // Filas con bits de relleno a 1 (debe ser 0)
+};
+
+// PoseFilter sobre una trayectoria fija (ver checkPoseFilter). Distancias en pixels.
+struct FilterCheckResult {
+    double spikeError = 0.0;         // Salida frente a la trayectoria real en el frame del pico
+    double pendingJumpError = 0.0;   // Ídem en los frames del salto que aún se descartan
+    double acceptedJumpError = 0.0;  // Salida frente a la medida cuando se acepta el salto
+    std::uint64_t rejected = 0;      // Muestras descartadas (deben ser 1 + maxConsecutiveOutliers)
+    double extrapolationTravel = 0.0; // Avance extrapolado hasta maxExtrapolationSeconds
+    double extrapolationOvershoot = 0.0; // Avance extra más allá del límite (debe ser 0)
+    std::vector<std::string> failures;
+};
+
+struct AllocationResult {
+    std::string name;
+    std::uint64_t warmupAllocations;
+    std::uint64_t steadyAllocations; // Debe ser 0
+    int frames;
+};
+
+struct CrowdResult {
+    std::size_t figures;
+    double msPerFrame;
+    double figuresPerSecond;
+};
+
+struct ShmLatencyResult {
+    int frames = 0;
+    std::size_t received = 0; // Frames que el lector vio (el lector solo mira el último)
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+// Una fase del gobernador con la detección `load` veces más lenta de lo normal.
+struct GovernorPhase {
+    double load;
+    int detections;
+    std::uint64_t overBudget;  // Detecciones cuyo coste por frame superó el presupuesto
+    double steadyOverBudget;   // Fracción sobre el presupuesto en la segunda mitad de la fase
+    double meanCostMs;         // Coste medio por frame de cámara
+    std::uint64_t downgrades;
+    std::uint64_t upgrades;
+    std::string finalLevel;
+};
+
+struct GovernorResult {
+    double budgetMs = 0.0;
+    // Escalones que no cambian ningún ajuste respecto del anterior o cuyos ajustes apply() no
+    // copia al detector (debe ser 0)
+    int ladderViolations = 0;
+    std::vector<GovernorPhase> phases;
+};
+
+struct ScalingResult {
+    int sources;
+    unsigned threads;
+    std::uint64_t frames;
+    double seconds;
+    double framesPerSecond;
+    std::uint64_t orderViolations; // Poses de una fuente que llegaron fuera de orden (debe ser 0)
+    std::uint64_t stolenTasks;
+};
+
+// Cronometra una etapa dentro de un bucle por frame y acumula la muestra.
+class StageTimer {
+public:
+    explicit StageTimer(StageSamples& samples) : samples(samples), start(BenchClock::now()) {}
+    ~StageTimer() { samples.ms.push_back(elapsedMs(start)); }
+private:
+    StageSamples& samples;
+    BenchClock::time_point start;
+};
+
+std::vector<cv::Mat> generateFrames(const BenchOptions& options, cv::Size size,
+                                    std::vector<std::vector<cv::Point2f>>* truth) {
+    SyntheticVideoOptions videoOptions;
+    videoOptions.width = size.width;
+    videoOptions.height = size.height;
+    videoOptions.markers = options.markers;
+    videoOptions.noiseSigma = options.noise;
+    videoOptions.motion = options.motion;
+    videoOptions.specks = options.specks;
+    SyntheticVideo video(videoOptions);
+
+    std::vector<cv::Mat> frames(static_cast<std::size_t>(options.frames));
+    for (int i = 0; i < options.frames; ++i) {
+        video.render(i, frames[i]);
+        if (truth) truth->push_back(video.markerCenters());
+    }
+    return frames;
+}
+
+DetectionResult benchDetection(const BenchOptions& options, cv::Size size) {
+    std::vector<std::vector<cv::Point2f>> truth;
+    std::vector<cv::Mat> frames = generateFrames(options, size, &truth);
+
+    DetectionResult result;
+    result.size = size;
+    StageSamples legacyConvert{"legacy_color_conversion", {}};
+    StageSamples legacyThreshold{"legacy_threshold", {}};
+    StageSamples legacyMorphology{"legacy_erode_dilate", {}};
+    StageSamples legacyContours{"legacy_contours", {}};
+    StageSamples legacyMoments{"legacy_moments", {}};
+    StageSamples lutClassify{"lut_classify", {}};
+    StageSamples morphologyBytes{"morphology_bytes", {}};
+    StageSamples morphology{"morphology_bits", {}};
+    StageSamples blobs{"blob_extraction", {}};
+    StageSamples detectFull{"detect_full_frame", {}};
+    StageSamples detectChangeGate{"detect_full_frame_change_gate", {}};
+    StageSamples detectTracking{"detect_roi_tracking", {}};
+    StageSamples detectPyramid2{"detect_pyramid_x2", {}};
+    StageSamples detectPyramid4{"detect_pyramid_x4", {}};
+
+    // --- Ruta original: cvtColor + inRange + erode/dilate + findContours + contourArea/moments ---
+    MotionCapture defaults;
+    const HsvRange& blue = defaults.markerColors.front().range;
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::Mat hsv, mask;
+    std::vector<std::vector<cv::Point>> contours;
+    for (const cv::Mat& frame : frames) {
+        { StageTimer t(legacyConvert); cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV); }
+        { StageTimer t(legacyThreshold);
+          cv::inRange(hsv, cv::Scalar(blue.hMin, blue.sMin, blue.vMin), cv::Scalar(blue.hMax, blue.sMax, blue.vMax), mask); }
+        { StageTimer t(legacyMorphology);
+          cv::erode(mask, mask, kernel, cv::Point(-1, -1), 1);
+          cv::dilate(mask, mask, kernel, cv::Point(-1, -1), 2); }
+        { StageTimer t(legacyContours); cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE); }
+        { StageTimer t(legacyMoments);
+          double sink = 0.0;
+          for (const auto& contour : contours) {
+              if (cv::contourArea(contour) > defaults.minContourArea) sink += cv::moments(contour).m00;
+          }
+          (void)sink; }
+    }
+
+    // --- Ruta actual, etapa por etapa ---
+    ColorLut lut;
+    std::vector<HsvRange> ranges;
+    for (const auto& color : defaults.markerColors) ranges.push_back(color.range);
+    lut.update(ranges);
+    BlobExtractor extractor;
+    LabelMorphology labelMorphology;
+    BitMorphology bitMorphology;
+    BitMask foreground;
+    cv::Mat labels, byteMask;
+    for (const cv::Mat& frame : frames) {
+        { StageTimer t(lutClassify); lut.classify(frame, labels); }
+        // Referencia: la misma morfología sobre la imagen de etiquetas, un byte por pixel.
+        labels.copyTo(byteMask);
+        { StageTimer t(morphologyBytes);
+          labelMorphology.erode(byteMask, 5, 1);
+          labelMorphology.dilate(byteMask, 5, 2); }
+        { StageTimer t(morphology);
+          foreground.fromLabels(labels);
+          bitMorphology.erode(foreground, 5, 1);
+          bitMorphology.dilate(foreground, 5, 2); }
+        { StageTimer t(blobs); extractor.extract(foreground, cv::Point(), labels, static_cast<int>(ranges.size())); }
+    }
+
+    // --- Detección completa: resolución completa, incremental por tiles, seguimiento por ventanas y piramidal ---
+    MotionCapture fullFrame;
+    fullFrame.roiTrackingEnabled = false;
+    fullFrame.changeGateEnabled = false;
+    MotionCapture changeGate;
+    changeGate.roiTrackingEnabled = false;
+    MotionCapture tracking;
+    MotionCapture pyramid2;
+    pyramid2.roiTrackingEnabled = false;
+    pyramid2.pyramidScale = 2;
+    MotionCapture pyramid4;
+    pyramid4.roiTrackingEnabled = false;
+    pyramid4.pyramidScale = 4;
+
+    DetectedPose fullPose, changeGatePose, trackingPose, pyramid2Pose, pyramid4Pose, truthPose;
+    ErrorAccumulator fullError, trackingError, pyramid2Error, pyramid4Error, pyramid2VsFull, pyramid4VsFull, changeGateVsFull;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        { StageTimer t(detectFull); fullFrame.detectMarkers(frames[i], fullPose); }
+        { StageTimer t(detectChangeGate); changeGate.detectMarkers(frames[i], changeGatePose); }
+        { StageTimer t(detectTracking); tracking.detectMarkers(frames[i], trackingPose); }
+        { StageTimer t(detectPyramid2); pyramid2.detectMarkers(frames[i], pyramid2Pose); }
+        { StageTimer t(detectPyramid4); pyramid4.detectMarkers(frames[i], pyramid4Pose); }
+
+        // Los primeros marcadores (uno por color) corresponden a las articulaciones de la tabla.
+        truthPose.clear();
+        for (std::size_t m = 0; m < truth[i].size() && m < defaults.markerColors.size(); ++m) {
+            truthPose.set(defaults.markerColors[m].joint, sf::Vector2f(truth[i][m].x, truth[i][m].y), 1.f);
+        }
+        fullError.add(fullPose, truthPose);
+        trackingError.add(trackingPose, truthPose);
+        pyramid2Error.add(pyramid2Pose, truthPose);
+        pyramid4Error.add(pyramid4Pose, truthPose);
+        pyramid2VsFull.add(pyramid2Pose, fullPose);
+        pyramid4VsFull.add(pyramid4Pose, fullPose);
+        changeGateVsFull.add(changeGatePose, fullPose);
+    }
+    result.accuracy = {{"full_vs_truth_px", fullError.mean()},
+                       {"roi_tracking_vs_truth_px", trackingError.mean()},
+                       {"pyramid_x2_vs_truth_px", pyramid2Error.mean()},
+                       {"pyramid_x4_vs_truth_px", pyramid4Error.mean()},
+                       {"pyramid_x2_vs_full_px", pyramid2VsFull.mean()},
+                       {"pyramid_x4_vs_full_px", pyramid4VsFull.mean()},
+                       {"change_gate_vs_full_px", changeGateVsFull.mean()}};
+
+    result.stages = {legacyConvert, legacyThreshold, legacyMorphology, legacyContours, legacyMoments,
+                     lutClassify, morphologyBytes, morphology, blobs, detectFull, detectChangeGate, detectTracking, detectPyramid2, detectPyramid4};
+    return result;
+}
+
+// Detectores de pose sobre la misma figura sintética: marcadores de color (cabeza y muñecas)
+// frente a la silueta sin marcadores (cabeza, muñecas y tobillos). La escena está vacía
+// mientras el detector de silueta aprende el fondo; solo se cronometran y se comparan los
+// frames con la figura. Añade las etapas detect_<detector> y su error a `result`.
+// Se mide con OpenCV en un solo hilo (resize, accumulateWeighted y distanceTransform podrían
+// repartirse entre núcleos); a 640x480 el detector de silueta debe caber en un frame de 60 Hz
+// (p95) y encontrar al menos kMinSilhouetteJointsFound de las articulaciones.
+void benchPoseDetectors(const BenchOptions& options, cv::Size size, DetectionResult& result) {
+    const int previousThreads = cv::getNumThreads();
+    cv::setNumThreads(1);
+    const int learningFrames = SilhouetteDetector().learningFrames;
+    SyntheticVideoOptions videoOptions;
+    videoOptions.width = size.width;
+    videoOptions.height = size.height;
+    videoOptions.noiseSigma = options.noise;
+    videoOptions.motion = options.motion;
+    videoOptions.figureFromFrame = learningFrames;
+    SyntheticVideo video(videoOptions);
+    const JointID extremityJoints[] = {JointID::HEAD, JointID::L_WRIST, JointID::R_WRIST, JointID::L_ANKLE, JointID::R_ANKLE};
+
+    for (const char* name : {"color", "silhouette"}) {
+        std::unique_ptr<PoseDetector> detector = makePoseDetector(name);
+        StageSamples samples{std::string("detect_") + name, {}};
+        ErrorAccumulator error;
+        int expected = 0, found = 0;
+        cv::Mat frame;
+        DetectedPose pose, truthPose;
+        for (int i = 0; i < learningFrames + options.frames; ++i) {
+            video.render(i, frame);
+            if (i < learningFrames) {
+                detector->detect(frame, pose);
+                continue;
+            }
+            { StageTimer t(samples); detector->detect(frame, pose); }
+
+            // El detector de color solo puede encontrar las articulaciones con marcador.
+            const std::vector<cv::Point2f>& extremities = video.figureExtremities();
+            const std::size_t joints = std::strcmp(name, "color") == 0 ? video.markerCenters().size() : extremities.size();
+            truthPose.clear();
+            for (std::size_t j = 0; j < joints; ++j) {
+                truthPose.set(extremityJoints[j], sf::Vector2f(extremities[j].x, extremities[j].y), 1.f);
+                expected += 1;
+                found += pose.has(extremityJoints[j]) ? 1 : 0;
+            }
+            error.add(pose, truthPose);
+        }
+        const double jointsFound = expected > 0 ? static_cast<double>(found) / expected : -1.0;
+        result.stages.push_back(samples);
+        result.accuracy.emplace_back(std::string(name) + "_vs_truth_px", error.mean());
+        result.accuracy.emplace_back(std::string(name) + "_joints_found", jointsFound);
+
+        if (std::strcmp(name, "silhouette") == 0 && size == cv::Size(640, 480)) {
+            const double p95 = samples.percentile(0.95);
+            result.accuracy.emplace_back("silhouette_p95_ms", p95);
+            if (p95 > kFrameBudgetMs) {
+                result.failures.push_back("detect_silhouette p95 " + std::to_string(p95) + " ms > " +
+                                          std::to_string(kFrameBudgetMs) + " ms");
+            }
+            if (jointsFound < kMinSilhouetteJointsFound) {
+                result.failures.push_back("silhouette_joints_found " + std::to_string(jointsFound) + " < " +
+                                          std::to_string(kMinSilhouetteJointsFound));
+            }
+        }
+    }
+    cv::setNumThreads(previousThreads);
+}
+
+// Una articulación a velocidad constante (10 pixels por frame a 30 fps) con un pico aislado
+// de 200 pixels en el frame 10 y un salto real de 300 pixels desde el frame 20. El pico debe
+// descartarse sin mover la salida; el salto se descarta maxConsecutiveOutliers frames y en
+// el siguiente la salida debe ser la medida. Antes del pico, la extrapolación debe pararse en
+// maxExtrapolationSeconds.
+FilterCheckResult checkPoseFilter() {
+    constexpr int kFrames = 30, kSpikeFrame = 10, kJumpFrame = 20;
+    constexpr float kStep = 10.f, kSpike = 200.f, kJump = 300.f;
+    const JointID joint = JointID::HEAD;
+    const std::size_t index = static_cast<std::size_t>(joint);
+    const PoseFilter::Clock::time_point start = PoseFilter::Clock::now();
+    auto captureTime = [&](int frame) { return start + std::chrono::microseconds(33333LL * frame); };
+    auto outputX = [&](const PoseFilter& filter, PoseFilter::Clock::time_point when) {
+        DetectedPose out;
+        filter.sample(when, out);
+        return out.confidence[index] > 0.f ? static_cast<double>(out.positions[index].x) : -1e9;
+    };
+
+    PoseFilter filter;
+    FilterCheckResult result;
+    const int acceptFrame = kJumpFrame + filter.maxConsecutiveOutliers;
+    DetectedPose pose;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        const float trueX = 100.f + kStep * static_cast<float>(frame);
+        float measured = trueX + (frame >= kJumpFrame ? kJump : 0.f);
+        if (frame == kSpikeFrame) measured += kSpike;
+        pose.clear();
+        pose.set(joint, sf::Vector2f(measured, 100.f), 1.f);
+        filter.addSample(pose, captureTime(frame));
+        const double x = outputX(filter, captureTime(frame));
+
+        if (frame == kSpikeFrame) {
+            result.spikeError = std::abs(x - trueX);
+        } else if (frame >= kJumpFrame && frame < acceptFrame) {
+            result.pendingJumpError = std::max(result.pendingJumpError, std::abs(x - trueX));
+        } else if (frame == acceptFrame) {
+            result.acceptedJumpError = std::abs(x - measured);
+        } else if (frame == kSpikeFrame - 1) {
+            const auto limit = std::chrono::duration_cast<PoseFilter::Clock::duration>(
+                std::chrono::duration<float>(filter.maxExtrapolationSeconds));
+            const double atLimit = outputX(filter, captureTime(frame) + limit);
+            result.extrapolationTravel = atLimit - x;
+            result.extrapolationOvershoot = std::abs(outputX(filter, captureTime(frame) + 3 * limit) - atLimit);
+        }
+    }
+    result.rejected = filter.rejectedCount();
+
+    auto require = [&](bool ok, const std::string& what) {
+        if (!ok) result.failures.push_back(what);
+    };
+    require(result.spikeError < 2.0, "el pico movió la salida " + std::to_string(result.spikeError) + " px");
+    require(result.pendingJumpError < 2.0, "la salida siguió al salto antes de confirmarlo");
+    require(result.acceptedJumpError < 0.01, "el salto confirmado no se aceptó");
+    require(result.rejected == static_cast<std::uint64_t>(1 + filter.maxConsecutiveOutliers),
+            "muestras descartadas: " + std::to_string(result.rejected));
+    require(result.extrapolationTravel > 0.5 * kStep, "no se extrapoló la velocidad");
+    require(result.extrapolationOvershoot < 0.01, "la extrapolación pasó de maxExtrapolationSeconds");
+    return result;
+}
+
+// Ejecuta las dos rutas de extracción sobre la misma máscara (inRange + erode/dilate de
+// OpenCV, para que solo cambie la extracción) y compara las manchas que superan
+// minContourArea, como en MotionCapture. Cada contorno externo se empareja con la mancha que
+// tiene el mismo rectángulo.
+//
+// Diferencias conocidas con la ruta original:
+//   - Manchas con huecos: el contorno externo encierra el hueco, pero Blob::contourArea()
+//     cuenta los pixels del borde interior como borde; y las manchas dentro de un hueco no
+//     tienen contorno con RETR_EXTERNAL. Se cuentan aparte y no se comparan.
+//   - Partes de un pixel de ancho: el contorno las recorre dos veces y el teorema de Pick deja
+//     de ser exacto. Tras erode x1 + dilate x2 con la elipse 5x5 no quedan en estas máscaras,
+//     así que una diferencia por esta causa también cuenta como fallo.
+//   - El centroide de moments() es el del polígono del contorno y el de Blob el de los pixels:
+//     no coinciden exactamente y la diferencia solo se informa.
+BlobCheckResult checkBlobExtraction(const BenchOptions& options) {
+    const cv::Size size = options.resolutions.empty() ? cv::Size(640, 480) : options.resolutions.front();
+    std::vector<cv::Mat> frames = generateFrames(options, size, nullptr);
+
+    MotionCapture defaults;
+    const double minArea = defaults.minContourArea;
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::Mat hsv, mask, wrapped;
+    std::vector<std::vector<cv::Point>> contours, components;
+    std::vector<cv::Vec4i> hierarchy;
+    std::vector<cv::Rect> holed; // Rectángulos de las componentes con algún hueco
+    std::vector<bool> matched;
+    BitMask bits;
+    BlobExtractor extractor;
+    BlobCheckResult result;
+
+    auto insideHoled = [&](const cv::Rect& rect) {
+        for (const cv::Rect& h : holed) {
+            if ((h & rect) == rect) return true;
+        }
+        return false;
+    };
+
+    for (const cv::Mat& frame : frames) {
+        cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
+        for (const auto& color : defaults.markerColors) {
+            const HsvRange& r = color.range;
+            if (r.hMin <= r.hMax) {
+                cv::inRange(hsv, cv::Scalar(r.hMin, r.sMin, r.vMin), cv::Scalar(r.hMax, r.sMax, r.vMax), mask);
+            } else {
+                // El tono da la vuelta (rojo): dos intervalos
+                cv::inRange(hsv, cv::Scalar(r.hMin, r.sMin, r.vMin), cv::Scalar(179, r.sMax, r.vMax), mask);
+                cv::inRange(hsv, cv::Scalar(0, r.sMin, r.vMin), cv::Scalar(r.hMax, r.sMax, r.vMax), wrapped);
+                cv::bitwise_or(mask, wrapped, mask);
+            }
+            cv::erode(mask, mask, kernel, cv::Point(-1, -1), 1);
+            cv::dilate(mask, mask, kernel, cv::Point(-1, -1), 2);
+            result.masks += 1;
+
+            cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+            cv::findContours(mask, components, hierarchy, cv::RETR_CCOMP, cv::CHAIN_APPROX_SIMPLE);
+            holed.clear();
+            for (std::size_t i = 0; i < components.size(); ++i) {
+                if (hierarchy[i][3] < 0 && hierarchy[i][2] >= 0) holed.push_back(cv::boundingRect(components[i]));
+            }
+
+            bits.fromLabels(mask);
+            extractor.extract(bits);
+            const std::vector<Blob>& blobs = extractor.blobs();
+            matched.assign(blobs.size(), false);
+
+            for (const auto& contour : contours) {
+                const cv::Rect rect = cv::boundingRect(contour);
+                const double area = cv::contourArea(contour);
+                const Blob* blob = nullptr;
+                for (std::size_t b = 0; b < blobs.size() && !blob; ++b) {
+                    if (!matched[b] && blobs[b].bounds() == rect) {
+                        matched[b] = true;
+                        blob = &blobs[b];
+                    }
+                }
+                const bool legacyAccepted = area > minArea;
+                const bool blobAccepted = blob && blob->contourArea() > minArea;
+                if (!legacyAccepted && !blobAccepted) continue;
+                if (insideHoled(rect)) {
+                    result.knownDifferences += 1;
+                } else if (legacyAccepted && blobAccepted) {
+                    const cv::Moments m = cv::moments(contour);
+                    const double dx = m.m10 / m.m00 - blob->centerX();
+                    const double dy = m.m01 / m.m00 - blob->centerY();
+                    result.accepted += 1;
+                    result.maxAreaError = std::max(result.maxAreaError, std::abs(area - blob->contourArea()));
+                    result.maxCentroidError = std::max(result.maxCentroidError, std::sqrt(dx * dx + dy * dy));
+                } else {
+                    result.mismatches += 1;
+                }
+            }
+            // Manchas sin contorno externo con el mismo rectángulo
+            for (std::size_t b = 0; b < blobs.size(); ++b) {
+                if (matched[b] || blobs[b].contourArea() <= minArea) continue;
+                if (insideHoled(blobs[b].bounds())) {
+                    result.knownDifferences += 1;
+                } else {
+                    result.mismatches += 1;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Erode x1 y después dilate x2 con la elipse 5x5, como en la detección, sobre las etiquetas de
+// los frames sintéticos: LabelMorphology sobre las etiquetas y BitMorphology sobre la máscara
+// binaria, comparadas después de cada paso con cv::erode/cv::dilate. Además del ancho
+// completo se prueban recortes (vistas no continuas) de anchos que no son múltiplo de 64,
+// para cubrir la última palabra parcial de BitMask.
+MorphologyCheckResult checkMorphology(const BenchOptions& options) {
+    const cv::Size size = options.resolutions.empty() ? cv::Size(640, 480) : options.resolutions.front();
+    std::vector<cv::Mat> frames = generateFrames(options, size, nullptr);
+
+    MotionCapture defaults;
+    ColorLut lut;
+    std::vector<HsvRange> ranges;
+    for (const auto& color : defaults.markerColors) ranges.push_back(color.range);
+    lut.update(ranges);
+
+    const int widths[] = {size.width, size.width - 1, size.width - 65, 101};
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::Mat labels, byteMask, expected, binary, expectedBinary, bitResult, diff;
+    LabelMorphology labelMorphology;
+    BitMorphology bitMorphology;
+    BitMask bits;
+    MorphologyCheckResult result;
+
+    auto differences = [&](const cv::Mat& a, const cv::Mat& b) {
+        cv::absdiff(a, b, diff);
+        return static_cast<std::uint64_t>(cv::countNonZero(diff));
+    };
+    auto compareBits = [&]() {
+        bits.toMat(bitResult);
+        result.bitMismatches += differences(bitResult, expectedBinary);
+        for (int y = 0; y < bits.rows(); ++y) {
+            if (bits.row(y)[bits.wordsPerRow() - 1] & ~bits.lastWordMask()) result.paddingViolations += 1;
+        }
+    };
+
+    for (const cv::Mat& frame : frames) {
+        lut.classify(frame, labels);
+        for (int width : widths) {
+            if (width <= 0 || width > labels.cols) continue;
+            const cv::Mat view = labels(cv::Rect(0, 0, width, labels.rows));
+            result.masks += 1;
+
+            view.copyTo(byteMask);
+            view.copyTo(expected);
+            cv::threshold(view, binary, 0, 255, cv::THRESH_BINARY);
+            binary.copyTo(expectedBinary);
+            bits.fromLabels(view);
+
+            labelMorphology.erode(byteMask, 5, 1);
+            bitMorphology.erode(bits, 5, 1);
+            cv::erode(expected, expected, kernel, cv::Point(-1, -1), 1);
+            cv::erode(expectedBinary, expectedBinary, kernel, cv::Point(-1, -1), 1);
+            result.byteMismatches += differences(byteMask, expected);
+            compareBits();
+
+            labelMorphology.dilate(byteMask, 5, 2);
+            bitMorphology.dilate(bits, 5, 2);
+            cv::dilate(expected, expected, kernel, cv::Point(-1, -1), 2);
+            cv::dilate(expectedBinary, expectedBinary, kernel, cv::Point(-1, -1), 2);
+            result.byteMismatches += differences(byteMask, expected);
+            compareBits();
+        }
+    }
+    return result;
+}
+
+// Ticks de captura (frame copiado en el buffer del contexto como haría cap.read, espejado en
+// el sitio, detección y vista de debug con máscara) sobre los mismos frames dos veces: la
+// primera pasada calienta los buffers y en la segunda no debería haber ninguna reserva.
+std::vector<AllocationResult> benchAllocations(const BenchOptions& options) {
+    const cv::Size size = options.resolutions.empty() ? cv::Size(640, 480) : options.resolutions.front();
+    std::vector<cv::Mat> frames = generateFrames(options, size, nullptr);
+
+    struct Config {
+        const char* name;
+        bool roiTracking;
+        int pyramidScale;
+    };
+    const Config configs[] = {{"full_frame", false, 1}, {"roi_tracking", true, 1}, {"pyramid_x2", false, 2}};
+
+    std::vector<AllocationResult> results;
+    for (const Config& config : configs) {
+        MotionCapture tracker;
+        tracker.roiTrackingEnabled = config.roiTracking;
+        tracker.pyramidScale = config.pyramidScale;
+        FrameContext context;
+        auto tick = [&](const cv::Mat& source) {
+            source.copyTo(context.frame);
+            cv::flip(context.frame, context.frame, 1);
+            context.valid = true;
+            tracker.detectMarkers(context.frame, context.pose);
+            tracker.displayDebugCameraView(context, true);
+        };
+
+        std::uint64_t before = alloc_counter::count();
+        for (const cv::Mat& frame : frames) tick(frame);
+        std::uint64_t warmup = alloc_counter::count() - before;
+
+        before = alloc_counter::count();
+        for (const cv::Mat& frame : frames) tick(frame);
+        std::uint64_t steady = alloc_counter::count() - before;
+
+        results.push_back({config.name, warmup, steady, static_cast<int>(frames.size())});
+    }
+    return results;
+}
+
+std::vector<StageSamples> benchRender(int iterations) {
+    StageSamples animate{"animate_demo_figure", {}};
+    StageSamples mix{"animation_mixer_evaluate", {}};
+    StageSamples draw{"stick_figure_draw_offscreen", {}};
+
+    StickFigure figure;
+    figure.initialize({1024, 768});
+    for (int i = 0; i < iterations; ++i) {
+        StageTimer t(animate);
+        animateDemoFigure(figure, 0.016f * static_cast<float>(i), {1024, 768});
+    }
+
+    // Dos capas activas todo el tiempo (fundido continuo entre reposo y saludo).
+    AnimationClip idle = bakeIdleClip();
+    AnimationClip wave = bakeWaveClip();
+    AnimationMixer mixer;
+    DetectedPose mixed;
+    for (int i = 0; i < iterations; ++i) {
+        if (i % 60 == 0) {
+            mixer.crossfadeTo((i / 60) % 2 == 0 ? &wave : &idle, 2.f);
+        }
+        StageTimer t(mix);
+        mixer.update(0.016f);
+        mixer.evaluate({512.f, 384.f}, 1.f, mixed);
+        figure.updatePose(mixed);
+    }
+
+    sf::RenderTexture target;
+    if (!target.resize({1024, 768})) {
+        std::cerr << "Aviso: no se pudo crear el destino offscreen (¿sin contexto OpenGL?); se omite draw." << std::endl;
+        return {animate, mix};
+    }
+    for (int i = 0; i < iterations; ++i) {
+        animateDemoFigure(figure, 0.016f * static_cast<float>(i), {1024, 768});
+        StageTimer t(draw);
+        target.clear(sf::Color(220, 220, 220));
+        figure.draw(target);
+        target.display();
+    }
+    return {animate, mix, draw};
+}
+
+// Exportación sin ventana de 10 s de la demo a un video temporal: render offscreen y
+// codificación MJPG en el hilo del codificador. Sin contexto OpenGL devuelve frames = 0.
+VideoExporter::Stats benchExport() {
+    ExportOptions exportOptions;
+    exportOptions.outputPath = (std::filesystem::temp_directory_path() / "motion_bench_export.avi").string();
+    VideoExporter exporter(exportOptions);
+    exporter.run();
+    std::error_code ignored;
+    std::filesystem::remove(exportOptions.outputPath, ignored);
+    return exporter.stats();
+}
+
+// Pose fuente que se mueve un poco en cada frame, para que el retargeting no sea trivial.
+std::array<sf::Vector2f, kJointCount> wigglePose(const StickFigure& base, int frame) {
+    std::array<sf::Vector2f, kJointCount> joints = base.joints();
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        joints[j].x += 5.f * std::sin(0.1f * static_cast<float>(frame + static_cast<int>(j)));
+        joints[j].y += 5.f * std::cos(0.1f * static_cast<float>(frame + static_cast<int>(j)));
+    }
+    return joints;
+}
+
+// Figuras por segundo que PoseBatch puede actualizar (retargeting + vértices). No incluye
+// el envío a la GPU.
+std::vector<CrowdResult> benchCrowd(ParallelFor& workers) {
+    constexpr int kFrames = 120;
+    std::vector<CrowdResult> results;
+
+    StickFigure base;
+    base.initialize({1024, 768});
+    for (std::size_t count : {100, 500, 1000, 2000, 5000, 10000, 20000}) {
+        PoseBatch crowd;
+        crowd.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            crowd.addFigure({static_cast<float>(i % 100) * 10.f, static_cast<float>(i / 100) * 10.f},
+                            0.1f, static_cast<std::uint32_t>(i % PoseBatch::kHistoryLength));
+        }
+        // Calentamiento: llena el historial y toca todos los buffers.
+        for (int f = 0; f < static_cast<int>(PoseBatch::kHistoryLength); ++f) {
+            crowd.pushSourcePose(wigglePose(base, f));
+        }
+        crowd.update(workers);
+
+        auto start = BenchClock::now();
+        for (int f = 0; f < kFrames; ++f) {
+            crowd.pushSourcePose(wigglePose(base, f));
+            crowd.update(workers);
+        }
+        double msPerFrame = elapsedMs(start) / kFrames;
+        results.push_back({count, msPerFrame, static_cast<double>(count) / (msPerFrame / 1000.0)});
+    }
+    return results;
+}
+
+// Latencia entre procesos del anillo compartido: un proceso hijo (fork) espera activamente
+// a que cambie el contador de frames publicados y mide desde que el padre escribió el frame
+// hasta que él lo lee. Los resultados vuelven al padre por un pipe.
+ShmLatencyResult benchSharedMemory(int frames) {
+    ShmLatencyResult result;
+    result.frames = frames;
+    const std::string name = "motion_bench_" + std::to_string(getpid());
+    PoseShmPublisher publisher;
+    int fds[2];
+    if (!publisher.open(name, 64) || pipe(fds) != 0) {
+        return result;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        ::close(fds[0]);
+        std::vector<std::int64_t> latencies;
+        latencies.reserve(static_cast<std::size_t>(frames));
+        PoseShmReader reader;
+        if (reader.open(name)) {
+            const std::int64_t deadline = pose_shm::nowNs() + 10'000'000'000LL;
+            std::uint64_t seen = 0;
+            pose_shm::Frame frame;
+            while (seen < static_cast<std::uint64_t>(frames) && pose_shm::nowNs() < deadline) {
+                std::uint64_t published = reader.publishedCount();
+                if (published == seen) {
+                    continue;
+                }
+                if (reader.read(published - 1, frame)) {
+                    latencies.push_back(pose_shm::nowNs() - frame.publishTimeNs);
+                }
+                seen = published;
+            }
+        }
+        const char* data = reinterpret_cast<const char*>(latencies.data());
+        std::size_t remaining = latencies.size() * sizeof(std::int64_t);
+        while (remaining > 0) {
+            ssize_t written = ::write(fds[1], data, remaining);
+            if (written <= 0) break;
+            data += written;
+            remaining -= static_cast<std::size_t>(written);
+        }
+        _exit(0);
+    }
+    ::close(fds[1]);
+    if (child < 0) {
+        ::close(fds[0]);
+        return result;
+    }
+
+    // Dar tiempo al hijo para mapear el anillo antes de empezar a publicar.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    StickFigure figure;
+    figure.initialize({1024, 768});
+    DetectedPose pose;
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        pose.set(static_cast<JointID>(j), figure.joints()[j], 1.f);
+    }
+    for (int i = 0; i < frames; ++i) {
+        publisher.publish(pose, BenchClock::now());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    std::vector<std::int64_t> latencies;
+    std::int64_t value = 0;
+    while (::read(fds[0], &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+        latencies.push_back(value);
+    }
+    ::close(fds[0]);
+    waitpid(child, nullptr, 0);
+    publisher.close();
+    shm_unlink(("/" + name).c_str());
+
+    result.received = latencies.size();
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&](double p) { return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))] / 1000.0; };
+        result.p50Us = at(0.50);
+        result.p99Us = at(0.99);
+        result.maxUs = latencies.back() / 1000.0;
+    }
+    return result;
+}
+
+// Gobernador de detección bajo carga sintética: la detección de cada frame se alarga con
+// una espera activa hasta `load` veces su duración (una máquina más lenta) en fases de
+// carga normal, alta y normal otra vez. En cada fase se cuentan las detecciones sobre el
+// presupuesto, los cambios de nivel y el coste por frame de cámara, como en CapturePipeline.
+GovernorResult benchGovernor(const BenchOptions& options) {
+    constexpr int kFramesPerPhase = 600;
+    const double loads[] = {1.0, 8.0, 1.0};
+    std::vector<cv::Mat> frames = generateFrames(options, cv::Size(640, 480), nullptr);
+
+    GovernorResult result;
+    result.budgetMs = options.budgetMs;
+    if (result.budgetMs <= 0.0) {
+        MotionCapture reference;
+        reference.roiTrackingEnabled = false;
+        StageSamples full{"full_frame", {}};
+        DetectedPose pose;
+        for (const cv::Mat& frame : frames) {
+            StageTimer t(full);
+            reference.detectMarkers(frame, pose);
+        }
+        result.budgetMs = 3.0 * full.median();
+    }
+
+    // Cada escalón, aplicado a un detector, debe dejar sus ajustes y diferir del anterior en
+    // alguno: si no, bajar un escalón no abarataría nada.
+    {
+        DetectionGovernor probe;
+        MotionCapture applied;
+        std::array<int, 6> previous{};
+        for (std::size_t i = 0; i < probe.ladder().size(); ++i) {
+            const DetectionQuality& q = probe.ladder()[i];
+            probe.reset(static_cast<int>(i));
+            probe.apply(applied);
+            const std::array<int, 6> settings = {applied.pyramidScale, applied.erodeIterations, applied.dilateIterations,
+                                                 applied.roiTrackingEnabled ? 1 : 0, applied.fullScanInterval,
+                                                 probe.quality().detectionInterval};
+            const std::array<int, 6> expected = {q.pyramidScale, q.erodeIterations, q.dilateIterations,
+                                                 q.roiTracking ? 1 : 0, q.fullScanInterval, q.detectionInterval};
+            if (settings != expected || (i > 0 && settings == previous)) {
+                result.ladderViolations += 1;
+            }
+            previous = settings;
+        }
+    }
+
+    MotionCapture tracker;
+    DetectionGovernor governor;
+    governor.budgetMs = result.budgetMs;
+    governor.reset();
+    governor.apply(tracker);
+    DetectedPose pose;
+    std::size_t frameIndex = 0;
+    int framesSinceDetection = 0;
+    for (double load : loads) {
+        DetectionGovernor::Stats before = governor.stats();
+        std::vector<double> costs;
+        for (int f = 0; f < kFramesPerPhase; ++f) {
+            const cv::Mat& frame = frames[frameIndex++ % frames.size()];
+            const int interval = governor.quality().detectionInterval;
+            if (++framesSinceDetection < interval) {
+                continue;
+            }
+            framesSinceDetection = 0;
+            auto start = BenchClock::now();
+            tracker.detectMarkers(frame, pose);
+            auto target = start + std::chrono::duration_cast<BenchClock::duration>((BenchClock::now() - start) * load);
+            while (BenchClock::now() < target) {
+            }
+            costs.push_back(elapsedMs(start) / interval);
+            if (governor.record(BenchClock::now() - start, interval)) {
+                governor.apply(tracker);
+            }
+        }
+        DetectionGovernor::Stats after = governor.stats();
+
+        GovernorPhase phase;
+        phase.load = load;
+        phase.detections = static_cast<int>(costs.size());
+        phase.overBudget = after.framesOverBudget - before.framesOverBudget;
+        std::size_t half = costs.size() / 2;
+        std::size_t steadyOver = static_cast<std::size_t>(std::count_if(costs.begin() + static_cast<std::ptrdiff_t>(half), costs.end(),
+                                                                        [&](double ms) { return ms > result.budgetMs; }));
+        phase.steadyOverBudget = costs.size() > half ? static_cast<double>(steadyOver) / static_cast<double>(costs.size() - half) : 0.0;
+        double total = 0.0;
+        for (double ms : costs) total += ms;
+        phase.meanCostMs = costs.empty() ? 0.0 : total / static_cast<double>(costs.size());
+        phase.downgrades = after.downgrades - before.downgrades;
+        phase.upgrades = after.upgrades - before.upgrades;
+        phase.finalLevel = governor.quality().name;
+        result.phases.push_back(phase);
+    }
+    return result;
+}
+
+// Escribe `count` videos sintéticos (MJPG, 640x480, 30 fps) distintos para usarlos como cámaras.
+std::vector<std::string> writeSourceVideos(const BenchOptions& options, int count) {
+    std::vector<std::string> paths;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    for (int i = 0; i < count; ++i) {
+        SyntheticVideoOptions videoOptions;
+        videoOptions.markers = options.markers;
+        videoOptions.noiseSigma = options.noise;
+        videoOptions.motion = options.motion;
+        videoOptions.specks = options.specks;
+        videoOptions.seed = static_cast<std::uint32_t>(i + 1);
+        SyntheticVideo video(videoOptions);
+        std::string path = (dir / ("motion_bench_source_" + std::to_string(i) + ".avi")).string();
+        cv::VideoWriter writer;
+        if (!writer.open(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 30.0,
+                         cv::Size(videoOptions.width, videoOptions.height))) {
+            std::cerr << "Aviso: no se pudo escribir " << path << " (¿OpenCV sin codificador MJPG?)." << std::endl;
+            return {};
+        }
+        cv::Mat frame;
+        for (int f = 0; f < options.sourceFrames; ++f) {
+            video.render(f, frame);
+            writer.write(frame);
+        }
+        writer.release();
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+// Frames por segundo (sumando todas las fuentes) de MultiSourceCapture con 1..N archivos
+// procesados sin descartar frames, para distintos números de hilos de detección. La
+// decodificación corre en los hilos de lectura de cada fuente, fuera del grupo.
+std::vector<ScalingResult> benchScaling(const BenchOptions& options) {
+    std::vector<ScalingResult> results;
+    std::vector<std::string> paths = writeSourceVideos(options, options.sources);
+    if (paths.empty()) {
+        return results;
+    }
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned t : {1u, 2u, 4u, 8u, cores}) {
+        if (t <= cores && std::find(threadCounts.begin(), threadCounts.end(), t) == threadCounts.end()) {
+            threadCounts.push_back(t);
+        }
+    }
+
+    for (unsigned threads : threadCounts) {
+        for (int sourceCount = 1; sourceCount <= options.sources; ++sourceCount) {
+            MultiSourceCapture capture(threads);
+            std::vector<std::int64_t> lastFrame(static_cast<std::size_t>(sourceCount), -1);
+            std::atomic<std::uint64_t> poses{0};
+            std::atomic<std::uint64_t> violations{0};
+            for (int i = 0; i < sourceCount; ++i) {
+                CaptureSourceConfig config;
+                config.path = paths[static_cast<std::size_t>(i)];
+                config.realtime = false;
+                config.loop = false;
+                config.mirror = false;
+                capture.addSource(config);
+            }
+            // Nunca hay dos llamadas a la vez para la misma fuente: lastFrame[source] no necesita lock.
+            capture.setPoseCallback([&](std::size_t source, const PosePacket& pose) {
+                if (static_cast<std::int64_t>(pose.frameId) <= lastFrame[source]) {
+                    violations.fetch_add(1, std::memory_order_relaxed);
+                }
+                lastFrame[source] = static_cast<std::int64_t>(pose.frameId);
+                poses.fetch_add(1, std::memory_order_relaxed);
+            });
+
+            auto start = BenchClock::now();
+            if (!capture.start()) {
+                return results;
+            }
+            capture.waitUntilDrained();
+            double seconds = elapsedMs(start) / 1000.0;
+            WorkStealingPool::Stats poolStats = capture.poolStats();
+            capture.stop();
+
+            std::uint64_t frames = poses.load();
+            results.push_back({sourceCount, threads, frames, seconds,
+                               seconds > 0.0 ? static_cast<double>(frames) / seconds : 0.0,
+                               violations.load(), poolStats.stolen});
+        }
+    }
+    for (const std::string& path : paths) {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+    return results;
+}
+
+void writeStagesJson(std::ostream& out, const std::vector<StageSamples>& stages, const std::string& indent) {
+    out << "{\n";
+    for (std::size_t i = 0; i < stages.size(); ++i) {
+        out << indent << "  \"" << stages[i].name << "\": {\"median_ms\": " << stages[i].median()
+            << ", \"min_ms\": " << stages[i].min() << ", \"samples\": " << stages[i].ms.size() << "}"
+            << (i + 1 < stages.size() ? ",\n" : "\n");
+    }
+    out << indent << "}";
+}
+
+void printStages(const std::vector<StageSamples>& stages) {
+    for (const auto& stage : stages) {
+        std::cout << "    " << stage.name << ": " << stage.median() << " ms (min " << stage.min() << ")" << std::endl;
+    }
+}
+
+std::vector<cv::Size> parseResolutions(const std::string& text) {
+    std::vector<cv::Size> sizes;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int w = 0, h = 0;
+        if (std::sscanf(item.c_str(), "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+            sizes.emplace_back(w, h);
+        }
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    alloc_counter::install();
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (std::strcmp(argv[i], "--json") == 0) options.jsonPath = next();
+        else if (std::strcmp(argv[i], "--frames") == 0) options.frames = std::max(1, std::atoi(next()));
+        else if (std::strcmp(argv[i], "--markers") == 0) options.markers = std::max(0, std::atoi(next()));
+        else if (std::strcmp(argv[i], "--noise") == 0) options.noise = static_cast<float>(std::atof(next()));
+        else if (std::strcmp(argv[i], "--motion") == 0) options.motion = static_cast<float>(std::atof(next()));
+        else if (std::strcmp(argv[i], "--specks") == 0) options.specks = std::max(0, std::atoi(next()));
+        else if (std::strcmp(argv[i], "--threads") == 0) options.threads = static_cast<unsigned>(std::atoi(next()));
+        else if (std::strcmp(argv[i], "--resolutions") == 0) options.resolutions = parseResolutions(next());
+        else if (std::strcmp(argv[i], "--sources") == 0) options.sources = std::max(1, std::atoi(next()));
+        else if (std::strcmp(argv[i], "--source-frames") == 0) options.sourceFrames = std::max(1, std::atoi(next()));
+        else if (std::strcmp(argv[i], "--budget") == 0) options.budgetMs = std::max(0.0, std::atof(next()));
+        else if (std::strcmp(argv[i], "--only") == 0) options.only = next();
+    }
+    auto enabled = [&](const char* name) { return options.only.empty() || options.only == name; };
+
+    std::vector<DetectionResult> detection;
+    bool detectionFailure = false;
+    if (enabled("detect")) {
+        for (const cv::Size& size : options.resolutions) {
+            std::cout << "detect " << size.width << "x" << size.height << std::endl;
+            detection.push_back(benchDetection(options, size));
+            benchPoseDetectors(options, size, detection.back());
+            printStages(detection.back().stages);
+            for (const auto& [name, error] : detection.back().accuracy) {
+                std::cout << "    " << name << ": " << error << std::endl;
+            }
+            for (const std::string& failure : detection.back().failures) {
+                std::cout << "    FALLO: " << failure << std::endl;
+                detectionFailure = true;
+            }
+        }
+    }
+
+    MorphologyCheckResult morphologyCheck;
+    BlobCheckResult blobCheck;
+    FilterCheckResult filterCheck;
+    bool checkFailure = false;
+    if (enabled("check")) {
+        std::cout << "check (morfología y extracción de manchas frente a OpenCV, filtro de poses)" << std::endl;
+        morphologyCheck = checkMorphology(options);
+        checkFailure = morphologyCheck.byteMismatches != 0 || morphologyCheck.bitMismatches != 0 ||
+                       morphologyCheck.paddingViolations != 0;
+        std::cout << "    morfología (elipse 5x5, erode x1 + dilate x2): bytes=" << morphologyCheck.byteMismatches
+                  << "  bits=" << morphologyCheck.bitMismatches << " pixels distintos  relleno=" << morphologyCheck.paddingViolations
+                  << " en " << morphologyCheck.masks << " máscaras" << (checkFailure ? "  FALLO" : "  OK") << std::endl;
+        blobCheck = checkBlobExtraction(options);
+        checkFailure = checkFailure || blobCheck.mismatches != 0;
+        std::cout << "    manchas: aceptadas=" << blobCheck.accepted << "  distintas=" << blobCheck.mismatches
+                  << "  con huecos=" << blobCheck.knownDifferences << " en " << blobCheck.masks << " máscaras"
+                  << "  error máx: área=" << blobCheck.maxAreaError << " centroide=" << blobCheck.maxCentroidError << " px"
+                  << (blobCheck.mismatches == 0 ? "  OK" : "  FALLO") << std::endl;
+        filterCheck = checkPoseFilter();
+        checkFailure = checkFailure || !filterCheck.failures.empty();
+        std::cout << "    filtro: pico=" << filterCheck.spikeError << " px  salto pendiente=" << filterCheck.pendingJumpError
+                  << " px  salto aceptado=" << filterCheck.acceptedJumpError << " px  descartadas=" << filterCheck.rejected
+                  << "  extrapolación=" << filterCheck.extrapolationTravel << " px (+" << filterCheck.extrapolationOvershoot
+                  << " tras el límite)" << (filterCheck.failures.empty() ? "  OK" : "  FALLO") << std::endl;
+        for (const std::string& failure : filterCheck.failures) {
+            std::cout << "    FALLO: " << failure << std::endl;
+        }
+    }
+
+    std::vector<AllocationResult> allocations;
+    bool allocationFailure = false;
+    if (enabled("alloc")) {
+        std::cout << "alloc (reservas por tick tras el calentamiento)" << std::endl;
+        allocations = benchAllocations(options);
+        for (const auto& a : allocations) {
+            bool ok = a.steadyAllocations == 0;
+            allocationFailure = allocationFailure || !ok;
+            std::cout << "    " << a.name << ": calentamiento=" << a.warmupAllocations
+                      << "  estable=" << a.steadyAllocations << " en " << a.frames << " frames"
+                      << (ok ? "  OK" : "  FALLO") << std::endl;
+        }
+    }
+
+    std::vector<StageSamples> render;
+    if (enabled("render")) {
+        std::cout << "render" << std::endl;
+        render = benchRender(500);
+        printStages(render);
+    }
+
+    VideoExporter::Stats exported;
+    if (enabled("export")) {
+        std::cout << "export (demo de 10 s a 1024x768, 30 fps)" << std::endl;
+        exported = benchExport();
+        std::cout << "    fps=" << exported.framesPerSecond << "  x tiempo real=" << exported.realtimeFactor
+                  << "  render fps=" << exported.renderFps << "  codificación fps=" << exported.encodeFps
+                  << "  esperas=" << exported.producerWaits << std::endl;
+    }
+
+    ShmLatencyResult shm;
+    if (enabled("shm")) {
+        std::cout << "shm (latencia publicador -> lector en otro proceso)" << std::endl;
+        shm = benchSharedMemory(5000);
+        std::cout << "    recibidos=" << shm.received << "/" << shm.frames << "  p50=" << shm.p50Us
+                  << " us  p99=" << shm.p99Us << " us  max=" << shm.maxUs << " us" << std::endl;
+    }
+
+    GovernorResult governor;
+    bool governorFailure = false;
+    if (enabled("governor")) {
+        governor = benchGovernor(options);
+        std::cout << "governor (presupuesto " << governor.budgetMs << " ms por frame, 640x480)" << std::endl;
+        governorFailure = governor.ladderViolations != 0;
+        std::cout << "    escalones sin cambio de ajustes: " << governor.ladderViolations
+                  << (governorFailure ? "  FALLO" : "  OK") << std::endl;
+        for (const auto& phase : governor.phases) {
+            std::cout << "    carga=x" << phase.load << "  detecciones=" << phase.detections
+                      << "  sobre presupuesto=" << phase.overBudget
+                      << " (" << 100.0 * phase.steadyOverBudget << "% en la 2ª mitad)"
+                      << "  coste medio=" << phase.meanCostMs << " ms"
+                      << "  bajadas=" << phase.downgrades << "  subidas=" << phase.upgrades
+                      << "  nivel final=" << phase.finalLevel << std::endl;
+        }
+    }
+
+    std::vector<CrowdResult> crowd;
+    ParallelFor workers(options.threads);
+    if (enabled("crowd")) {
+        std::cout << "crowd (" << workers.threadCount() << " hilos)" << std::endl;
+        crowd = benchCrowd(workers);
+        for (const auto& r : crowd) {
+            std::cout << "    figuras=" << r.figures << "  ms/frame=" << r.msPerFrame
+                      << "  figuras/s=" << static_cast<long long>(r.figuresPerSecond)
+                      << "  figuras@60fps=" << static_cast<long long>(r.figuresPerSecond / 60.0) << std::endl;
+        }
+    }
+
+    std::vector<ScalingResult> scaling;
+    bool orderFailure = false;
+    if (enabled("scaling")) {
+        std::cout << "scaling (1-" << options.sources << " fuentes de archivo, " << options.sourceFrames << " frames cada una)" << std::endl;
+        scaling = benchScaling(options);
+        for (const auto& r : scaling) {
+            orderFailure = orderFailure || r.orderViolations != 0;
+            std::cout << "    hilos=" << r.threads << "  fuentes=" << r.sources << "  fps=" << r.framesPerSecond
+                      << "  fps/fuente=" << r.framesPerSecond / r.sources << "  robadas=" << r.stolenTasks
+                      << (r.orderViolations == 0 ? "" : "  FUERA DE ORDEN") << std::endl;
+        }
+    }
+
+    std::ofstream json(options.jsonPath);
+    if (!json) {
+        std::cerr << "ERROR: No se pudo escribir " << options.jsonPath << std::endl;
+        return 1;
+    }
+    json << "{\n  \"config\": {\"frames\": " << options.frames << ", \"markers\": " << options.markers
+         << ", \"noise\": " << options.noise << ", \"motion\": " << options.motion
+         << ", \"specks\": " << options.specks << ", \"threads\": " << workers.threadCount() << "},\n";
+    json << "  \"detection\": [\n";
+    for (std::size_t i = 0; i < detection.size(); ++i) {
+        const auto& d = detection[i];
+        json << "    {\"width\": " << d.size.width << ", \"height\": " << d.size.height << ", \"accuracy\": {";
+        for (std::size_t a = 0; a < d.accuracy.size(); ++a) {
+            json << (a ? ", " : "") << "\"" << d.accuracy[a].first << "\": " << d.accuracy[a].second;
+        }
+        json << "}, \"stages\": ";
+        writeStagesJson(json, d.stages, "    ");
+        json << "}" << (i + 1 < detection.size() ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"check\": {\"morphology\": {\"masks\": " << morphologyCheck.masks
+         << ", \"byte_mismatches\": " << morphologyCheck.byteMismatches << ", \"bit_mismatches\": " << morphologyCheck.bitMismatches
+         << ", \"padding_violations\": " << morphologyCheck.paddingViolations << "},\n    \"blobs\": {\"masks\": " << blobCheck.masks << ", \"accepted\": " << blobCheck.accepted
+         << ", \"mismatches\": " << blobCheck.mismatches << ", \"known_differences\": " << blobCheck.knownDifferences
+         << ", \"max_area_error\": " << blobCheck.maxAreaError << ", \"max_centroid_error_px\": " << blobCheck.maxCentroidError << "},\n";
+    json << "    \"pose_filter\": {\"spike_error_px\": " << filterCheck.spikeError << ", \"pending_jump_error_px\": " << filterCheck.pendingJumpError
+         << ", \"accepted_jump_error_px\": " << filterCheck.acceptedJumpError << ", \"rejected\": " << filterCheck.rejected
+         << ", \"extrapolation_px\": " << filterCheck.extrapolationTravel << ", \"extrapolation_overshoot_px\": " << filterCheck.extrapolationOvershoot
+         << ", \"failures\": " << filterCheck.failures.size() << "}},\n";
+    json << "  \"steady_state_allocations\": [\n";
+    for (std::size_t i = 0; i < allocations.size(); ++i) {
+        json << "    {\"path\": \"" << allocations[i].name << "\", \"warmup\": " << allocations[i].warmupAllocations
+             << ", \"steady\": " << allocations[i].steadyAllocations << ", \"frames\": " << allocations[i].frames << "}"
+             << (i + 1 < allocations.size() ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"render\": ";
+    writeStagesJson(json, render, "  ");
+    json << ",\n  \"export\": {\"frames\": " << exported.frames << ", \"seconds\": " << exported.seconds
+         << ", \"fps\": " << exported.framesPerSecond << ", \"realtime_factor\": " << exported.realtimeFactor
+         << ", \"render_fps\": " << exported.renderFps << ", \"encode_fps\": " << exported.encodeFps
+         << ", \"producer_waits\": " << exported.producerWaits << "}";
+    json << ",\n  \"crowd\": [\n";
+    for (std::size_t i = 0; i < crowd.size(); ++i) {
+        json << "    {\"figures\": " << crowd[i].figures << ", \"ms_per_frame\": " << crowd[i].msPerFrame
+             << ", \"figures_per_second\": " << crowd[i].figuresPerSecond
+             << ", \"figures_at_60fps\": " << crowd[i].figuresPerSecond / 60.0 << "}"
+             << (i + 1 < crowd.size() ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"shm\": {\"frames\": " << shm.frames << ", \"received\": " << shm.received
+         << ", \"p50_us\": " << shm.p50Us << ", \"p99_us\": " << shm.p99Us << ", \"max_us\": " << shm.maxUs << "},\n";
+    json << "  \"governor\": {\"budget_ms\": " << governor.budgetMs << ", \"ladder_violations\": " << governor.ladderViolations
+         << ", \"phases\": [\n";
+    for (std::size_t i = 0; i < governor.phases.size(); ++i) {
+        const auto& phase = governor.phases[i];
+        json << "    {\"load\": " << phase.load << ", \"detections\": " << phase.detections
+             << ", \"over_budget\": " << phase.overBudget << ", \"steady_over_budget_fraction\": " << phase.steadyOverBudget
+             << ", \"mean_cost_ms\": " << phase.meanCostMs << ", \"downgrades\": " << phase.downgrades
+             << ", \"upgrades\": " << phase.upgrades << ", \"final_level\": \"" << phase.finalLevel << "\"}"
+             << (i + 1 < governor.phases.size() ? ",\n" : "\n");
+    }
+    json << "  ]},\n";
+    json << "  \"scaling\": [\n";
+    for (std::size_t i = 0; i < scaling.size(); ++i) {
+        const auto& r = scaling[i];
+        json << "    {\"sources\": " << r.sources << ", \"threads\": " << r.threads << ", \"frames\": " << r.frames
+             << ", \"seconds\": " << r.seconds << ", \"fps\": " << r.framesPerSecond
+             << ", \"fps_per_source\": " << r.framesPerSecond / r.sources
+             << ", \"order_violations\": " << r.orderViolations << ", \"stolen_tasks\": " << r.stolenTasks << "}"
+             << (i + 1 < scaling.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+    std::cout << "Resultados escritos en " << options.jsonPath << std::endl;
+    return (detectionFailure || checkFailure || allocationFailure || governorFailure || orderFailure) ? 2 : 0;
+}
@@ -0,0 +1,114 @@
+#include "synthetic_video.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+// Colores BGR que caen dentro de los rangos por defecto de MotionCapture::markerColors.
+const cv::Scalar kMarkerColors[] = {
+    cv::Scalar(220, 90, 30),  // Azul
+    cv::Scalar(40, 200, 40),  // Verde
+    cv::Scalar(40, 40, 220),  // Rojo
+};
+// Ropa oscura y poco saturada: no cae en ningún rango de marcador y contrasta con el fondo.
+const cv::Scalar kFigureColor(60, 45, 40);
+}
+
+SyntheticVideo::SyntheticVideo(const SyntheticVideoOptions& options) : opts(options) {
+    radius = opts.markerRadius * static_cast<float>(opts.height) / 480.f;
+
+    // Fondo gris en degradado, rebajado en la media del ruido para que la suma quede centrada.
+    const int noiseMean = opts.noiseSigma > 0.f ? static_cast<int>(2.f * opts.noiseSigma) : 0;
+    background.create(opts.height, opts.width, CV_8UC3);
+    for (int y = 0; y < opts.height; ++y) {
+        std::uint8_t* row = background.ptr<std::uint8_t>(y);
+        for (int x = 0; x < opts.width; ++x) {
+            int value = 90 + (60 * x) / std::max(1, opts.width) + (40 * y) / std::max(1, opts.height) - noiseMean;
+            row[3 * x + 0] = row[3 * x + 1] = row[3 * x + 2] = static_cast<std::uint8_t>(std::max(0, value));
+        }
+    }
+
+    std::mt19937 rng(opts.seed);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    for (int i = 0; i < opts.markers; ++i) {
+        float ax = (0.15f + 0.7f * unit(rng)) * static_cast<float>(opts.width);
+        float ay = (0.15f + 0.7f * unit(rng)) * static_cast<float>(opts.height);
+        float amplitude = 0.1f * static_cast<float>(std::min(opts.width, opts.height));
+        anchors.emplace_back(ax, ay);
+        amplitudes.emplace_back(amplitude, amplitude * (0.5f + 0.5f * unit(rng)));
+        phases.push_back(6.2831853f * unit(rng));
+    }
+    centers.resize(anchors.size());
+}
+
+cv::Scalar SyntheticVideo::markerColor(int i) const {
+    return kMarkerColors[i % 3];
+}
+
+void SyntheticVideo::render(int index, cv::Mat& frame) {
+    if (opts.noiseSigma > 0.f) {
+        noise.create(opts.height, opts.width, CV_8UC3);
+        cv::randn(noise, cv::Scalar::all(2.0 * opts.noiseSigma), cv::Scalar::all(opts.noiseSigma));
+        cv::add(background, noise, frame);
+    } else {
+        background.copyTo(frame);
+    }
+
+    if (opts.figureFromFrame >= 0) {
+        renderFigure(index, frame);
+    }
+    // Velocidad angular tal que el desplazamiento por frame sea ~motion pixels.
+    for (int i = 0; i < opts.markers && opts.figureFromFrame < 0; ++i) {
+        float omega = amplitudes[i].x > 0.f ? opts.motion / amplitudes[i].x : 0.f;
+        float t = omega * static_cast<float>(index);
+        centers[i] = cv::Point2f(anchors[i].x + amplitudes[i].x * std::sin(t + phases[i]),
+                                 anchors[i].y + amplitudes[i].y * std::sin(2.f * t + phases[i]));
+        cv::circle(frame, cv::Point(static_cast<int>(std::lround(centers[i].x)), static_cast<int>(std::lround(centers[i].y))),
+                   static_cast<int>(radius), markerColor(i), cv::FILLED, cv::LINE_8);
+    }
+
+    // Motas de color: del tamaño de un pixel o dos, deben desaparecer con la erosión.
+    std::mt19937 rng(opts.seed + static_cast<std::uint32_t>(index));
+    std::uniform_int_distribution<int> px(0, opts.width - 2), py(0, opts.height - 2);
+    for (int s = 0; s < opts.specks; ++s) {
+        cv::rectangle(frame, cv::Rect(px(rng), py(rng), 1 + s % 2, 1 + s % 2), markerColor(s), cv::FILLED);
+    }
+}
+
+void SyntheticVideo::renderFigure(int index, cv::Mat& frame) {
+    centers.clear();
+    extremities.clear();
+    if (index < opts.figureFromFrame) {
+        return;
+    }
+    // Proporciones a 480 px de alto. Los brazos suben y bajan en contrafase, con la mano
+    // moviéndose ~motion pixels por frame, y la figura se balancea despacio.
+    const float s = static_cast<float>(opts.height) / 480.f;
+    const float t = static_cast<float>(index - opts.figureFromFrame);
+    const float armLength = 130.f * s;
+    const float omega = opts.motion / armLength;
+    const float cx = 0.5f * static_cast<float>(opts.width) + 40.f * s * std::sin(0.2f * omega * t);
+    auto point = [](cv::Point2f p) { return cv::Point(static_cast<int>(std::lround(p.x)), static_cast<int>(std::lround(p.y))); };
+
+    const cv::Point2f head(cx, 100.f * s), neck(cx, 140.f * s), pelvis(cx, 290.f * s);
+    const cv::Point2f shoulder(cx, 170.f * s);
+    const float leftAngle = 0.6f * std::sin(omega * t), rightAngle = 0.6f * std::sin(omega * t + 3.1415927f);
+    const cv::Point2f leftWrist(shoulder.x - armLength * std::cos(leftAngle), shoulder.y - armLength * std::sin(leftAngle));
+    const cv::Point2f rightWrist(shoulder.x + armLength * std::cos(rightAngle), shoulder.y - armLength * std::sin(rightAngle));
+    const cv::Point2f leftAnkle(cx - 60.f * s, 440.f * s), rightAnkle(cx + 60.f * s, 440.f * s);
+
+    cv::circle(frame, point(head), static_cast<int>(24.f * s), kFigureColor, cv::FILLED, cv::LINE_8);
+    cv::line(frame, point(head), point(neck), kFigureColor, static_cast<int>(20.f * s), cv::LINE_8);
+    cv::line(frame, point(neck + cv::Point2f(0.f, 30.f * s)), point(pelvis), kFigureColor, static_cast<int>(70.f * s), cv::LINE_8);
+    cv::line(frame, point(shoulder), point(leftWrist), kFigureColor, static_cast<int>(18.f * s), cv::LINE_8);
+    cv::line(frame, point(shoulder), point(rightWrist), kFigureColor, static_cast<int>(18.f * s), cv::LINE_8);
+    cv::line(frame, point(pelvis - cv::Point2f(15.f * s, 0.f)), point(leftAnkle), kFigureColor, static_cast<int>(24.f * s), cv::LINE_8);
+    cv::line(frame, point(pelvis + cv::Point2f(15.f * s, 0.f)), point(rightAnkle), kFigureColor, static_cast<int>(24.f * s), cv::LINE_8);
+
+    extremities = {head, leftWrist, rightWrist, leftAnkle, rightAnkle};
+    const cv::Point2f marked[] = {head, leftWrist, rightWrist};
+    for (int i = 0; i < std::min(opts.markers, 3); ++i) {
+        centers.push_back(marked[i]);
+        cv::circle(frame, point(marked[i]), static_cast<int>(radius), markerColor(i), cv::FILLED, cv::LINE_8);
+    }
+}
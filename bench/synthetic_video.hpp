@@ -0,0 +1,54 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Opciones del generador de video sintético con marcadores de color.
+struct SyntheticVideoOptions {
+    int width = 640;
+    int height = 480;
+    int markers = 3;           // Los colores se reparten en orden: azul, verde, rojo, azul...
+    float markerRadius = 12.f; // A 480 px de alto; se escala con la resolución
+    float noiseSigma = 4.f;    // Ruido gaussiano por canal (0 = sin ruido)
+    float motion = 3.f;        // Desplazamiento aproximado de cada marcador por frame, en pixels
+    int specks = 0;            // Motas de color de 1-2 px (ruido que la morfología debe eliminar)
+    // Figura de una persona (silueta lisa que mueve los brazos): -1 = sin figura; si no, la
+    // escena está vacía hasta ese frame y después aparece la figura, con los tres primeros
+    // marcadores en la cabeza y las muñecas (el resto de marcadores no se dibuja).
+    int figureFromFrame = -1;
+    std::uint32_t seed = 1;
+};
+
+// Genera frames BGR con un fondo en degradado, ruido y marcadores circulares que se mueven
+// en trayectorias de Lissajous. Conoce la posición real de cada marcador en cada frame.
+class SyntheticVideo {
+public:
+    explicit SyntheticVideo(const SyntheticVideoOptions& options);
+
+    // Dibuja el frame `index` en `frame` (reutiliza su buffer).
+    void render(int index, cv::Mat& frame);
+    // Centros reales de los marcadores en el último frame dibujado.
+    const std::vector<cv::Point2f>& markerCenters() const { return centers; }
+    // Extremos reales de la figura en el último frame dibujado: cabeza, muñeca izquierda,
+    // muñeca derecha, tobillo izquierdo y tobillo derecho (izquierda = menor x). Vacío si
+    // la figura no estaba.
+    const std::vector<cv::Point2f>& figureExtremities() const { return extremities; }
+    // Color BGR del marcador i.
+    cv::Scalar markerColor(int i) const;
+
+    const SyntheticVideoOptions& options() const { return opts; }
+
+private:
+    void renderFigure(int index, cv::Mat& frame);
+
+    SyntheticVideoOptions opts;
+    cv::Mat background;
+    cv::Mat noise;
+    std::vector<cv::Point2f> anchors;
+    std::vector<cv::Point2f> amplitudes;
+    std::vector<float> phases;
+    std::vector<cv::Point2f> centers;
+    std::vector<cv::Point2f> extremities;
+    float radius;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Clip de animación: curvas muestreadas a frecuencia fija, una por articulación (JointID),
+// con posiciones relativas al centro de la figura en pixels a escala 1.
+//
+// Evaluar un clip cuesta lo mismo para cualquier instante: se calcula el frame anterior y
+// se interpola linealmente con el siguiente, para todas las articulaciones a la vez (los
+// datos de cada frame están contiguos, así que el bucle por articulación se vectoriza).
+//
+// Formato de archivo (.clip, texto):
+//   # comentario
+//   clip <nombre>
+//   rate <frames por segundo>
+//   loop <0|1>
+//   joints ALL | <JointID> <JointID> ...     (articulaciones que anima el clip)
+//   f <x y de HEAD> <x y de NECK> ...          (un frame por línea, kJointCount pares x y)
+class AnimationClip {
+public:
+    // Carga un clip en formato .clip. Devuelve false (y muestra el error) si no es válido.
+    bool loadFromFile(const std::string& path);
+    bool saveToFile(const std::string& path) const;
+
+    // Construye un clip muestreando `pose(t, xs, ys)` en frameCount instantes equiespaciados.
+    static AnimationClip bake(const std::string& name, float frameRate, std::size_t frameCount, bool loop,
+                              const std::function<void(float, float*, float*)>& pose);
+
+    const std::string& name() const { return clipName; }
+    float frameRate() const { return rate; }
+    std::size_t frameCount() const { return frames; }
+    float duration() const { return frames > 0 ? static_cast<float>(frames) / rate : 0.f; }
+    bool loops() const { return looping; }
+
+    // 1 para las articulaciones que anima el clip, 0 para las demás.
+    const std::array<float, kJointCount>& jointMask() const { return mask; }
+    void setJointMask(const std::array<float, kJointCount>& jointMask) { mask = jointMask; }
+
+    // Posiciones de todas las articulaciones en `time` segundos (con vuelta si el clip es
+    // cíclico, fijo en el último frame si no). xs/ys deben tener kJointCount elementos.
+    void sample(float time, float* xs, float* ys) const;
+
+private:
+    std::string clipName;
+    float rate = 30.f;
+    std::size_t frames = 0;
+    bool looping = true;
+    std::array<float, kJointCount> mask{};
+    // frames x kJointCount, frame a frame
+    std::vector<float> xs;
+    std::vector<float> ys;
+};
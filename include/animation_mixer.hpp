@@ -0,0 +1,56 @@
+#pragma once
+
+#include "animation_clip.hpp"
+#include "pose_types.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+
+// Mezclador de clips: hasta kMaxLayers capas, cada una con su propio tiempo y peso. Los
+// pesos se aproximan a su valor objetivo a velocidad constante, lo que da los fundidos
+// cruzados. Cada articulación es la media ponderada de las capas que la animan (según la
+// máscara de articulaciones de cada clip), así un clip parcial (p. ej. solo los brazos)
+// se combina con uno completo (p. ej. reposo).
+//
+// No reserva memoria: las capas son un array fijo y los clips no se copian (el mezclador
+// guarda punteros; los clips deben vivir más que él).
+class AnimationMixer {
+public:
+    static constexpr std::size_t kMaxLayers = 4;
+
+    // Lleva `clip` a peso 1 y todas las demás capas a 0 en fadeSeconds.
+    void crossfadeTo(const AnimationClip* clip, float fadeSeconds);
+    // Lleva la capa de `clip` (creándola si no existe) al peso indicado en fadeSeconds.
+    // Con peso 0, la capa se elimina cuando termina de desvanecerse.
+    void setLayer(const AnimationClip* clip, float weight, float fadeSeconds = 0.f);
+    void clear();
+
+    // Avanza el tiempo de las capas y los fundidos.
+    void update(float dt);
+
+    // Pose mezclada en coordenadas de pantalla (origin + posición del clip * scale). Las
+    // articulaciones que ninguna capa anima quedan con confianza 0.
+    void evaluate(sf::Vector2f origin, float scale, DetectedPose& out) const;
+
+    // Clip con mayor peso (nullptr si no hay capas).
+    const AnimationClip* dominantClip() const;
+
+private:
+    struct Layer {
+        const AnimationClip* clip = nullptr;
+        float time = 0.f;
+        float weight = 0.f;
+        float targetWeight = 0.f;
+        float fadeRate = 0.f; // Unidades de peso por segundo; 0 = cambio inmediato
+    };
+
+    std::array<Layer, kMaxLayers> layers{};
+};
+
+// Completa una pose animada con la captura en vivo: las articulaciones detectadas en `live`
+// sustituyen a las del clip y el resto (las que no tienen marcador) siguen la animación.
+// Las dos poses no están en el mismo espacio (el clip se evalúa alrededor de un origen
+// cualquiera, la captura en pixels de la cámara), así que antes el clip se lleva al de la
+// captura con la escala uniforme y la traslación que mejor superponen las articulaciones
+// comunes (con una sola, solo la traslación). Sin articulaciones comunes no se toca.
+void overlayLivePose(const DetectedPose& live, DetectedPose& animated);
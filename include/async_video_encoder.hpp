@@ -0,0 +1,64 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Escritura de video en un hilo propio. El productor (el hilo que renderiza) pide un buffer
+// libre con acquire(), copia en él los pixels RGBA del frame y lo entrega con submit(); el
+// hilo codificador convierte a BGR y lo escribe con cv::VideoWriter.
+//
+// Los buffers forman un anillo fijo que se reserva al abrir: no hay reservas por frame ni
+// copias entre hilos. Ningún frame se descarta: si el codificador va más lento que el
+// render y todos los buffers están en cola, acquire() espera (y se cuenta en producerWaits).
+class AsyncVideoEncoder {
+public:
+    struct Stats {
+        std::uint64_t framesWritten = 0;
+        std::uint64_t producerWaits = 0; // Veces que acquire() tuvo que esperar a un buffer libre
+        double encodeSeconds = 0.0;      // Tiempo del hilo codificador convirtiendo y escribiendo
+    };
+
+    AsyncVideoEncoder() = default;
+    ~AsyncVideoEncoder();
+
+    AsyncVideoEncoder(const AsyncVideoEncoder&) = delete;
+    AsyncVideoEncoder& operator=(const AsyncVideoEncoder&) = delete;
+
+    // Crea el archivo y arranca el hilo codificador. fourcc por defecto: MJPG (disponible en
+    // cualquier compilación de OpenCV con el backend de AVI propio).
+    bool open(const std::string& path, cv::Size frameSize, double fps, int bufferCount = 4,
+              int fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    bool isOpen() const { return worker.joinable(); }
+
+    // --- Lado del productor (un solo hilo) ---
+    // Buffer RGBA (CV_8UC4, frameSize) para el siguiente frame. Espera si no hay ninguno libre.
+    cv::Mat& acquire();
+    // Entrega al codificador el buffer del último acquire().
+    void submit();
+
+    // Espera a que se escriban todos los frames entregados, detiene el hilo y cierra el archivo.
+    void finish();
+
+    Stats stats() const;
+
+private:
+    void encodeLoop();
+
+    cv::VideoWriter writer;
+    std::vector<cv::Mat> buffers;
+    cv::Mat converted; // BGR para VideoWriter (solo lo usa el hilo codificador)
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::uint64_t submitted = 0; // Frames entregados; el siguiente se escribe en buffers[submitted % n]
+    std::uint64_t written = 0;   // Frames escritos; buffers[written % n] es el siguiente a codificar
+    bool closing = false;
+    std::uint64_t waits = 0;
+    double encodeSeconds = 0.0;
+    std::thread worker;
+};
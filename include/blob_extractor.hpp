@@ -0,0 +1,70 @@
+#pragma once
+
+#include "bit_mask.hpp"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Estadísticas de una componente conexa de la máscara.
+struct Blob {
+    std::uint32_t pixelCount = 0;
+    std::uint32_t borderPixels = 0; // Pixels con algún vecino 4-conexo vacío
+    double sumX = 0.0, sumY = 0.0;  // Primeros momentos (sobre pixels)
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    std::uint8_t label = 0;          // Etiqueta mayoritaria (solo si se pidió labelCount > 0)
+    std::uint32_t labelPixels = 0;   // Pixels con esa etiqueta
+    std::uint32_t votedPixels = 0;   // Pixels con alguna etiqueta (los de etiqueta 0 no votan)
+
+    // Área del contorno externo que daría cv::contourArea, por el teorema de Pick
+    // (A = pixels - borde/2 - 1). Es exacta para manchas sin huecos ni partes de un pixel de ancho.
+    double contourArea() const {
+        double area = static_cast<double>(pixelCount) - 0.5 * borderPixels - 1.0;
+        return area > 0.0 ? area : 0.0;
+    }
+    float centerX() const { return static_cast<float>(sumX / pixelCount); }
+    float centerY() const { return static_cast<float>(sumY / pixelCount); }
+    cv::Rect bounds() const { return cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1); }
+};
+
+// Extractor de componentes conexas (8-conectividad) en una sola pasada sobre la máscara.
+// Reemplaza findContours + contourArea + moments: la máscara se recorre una vez para
+// extraer tramos horizontales (runs), los runs se unen con union-find y las estadísticas
+// se acumulan por run, no por pixel. Todos los buffers se reutilizan entre llamadas.
+class BlobExtractor {
+public:
+    // Procesa una máscara CV_8UC1 (distinto de cero = primer plano). `offset` se suma a las
+    // coordenadas de salida, para máscaras que corresponden a una región del frame.
+    // Si labelCount > 0 la máscara es una imagen de etiquetas (1..labelCount) y cada
+    // componente recibe la etiqueta mayoritaria de sus pixels; componentes de colores
+    // distintos que se tocan forman una sola componente y gana el color dominante.
+    void extract(const cv::Mat& mask, cv::Point offset = cv::Point(), int labelCount = 0);
+
+    // Igual, pero sobre una máscara empaquetada: los runs se buscan de 64 en 64 pixels.
+    // Si labelCount > 0, `labels` (CV_8UC1 del mismo tamaño) da la etiqueta de cada pixel
+    // para la votación; los pixels con etiqueta 0 dentro de un run (p. ej. añadidos por la
+    // dilatación) no votan.
+    void extract(const BitMask& mask, cv::Point offset = cv::Point(), const cv::Mat& labels = cv::Mat(), int labelCount = 0);
+
+    // Resultados de la última llamada, en orden de aparición (de arriba a abajo).
+    const std::vector<Blob>& blobs() const { return results; }
+
+private:
+    struct Run {
+        int y, x0, x1; // x1 inclusivo
+        std::uint32_t borderPixels;
+    };
+
+    std::uint32_t findRoot(std::uint32_t i);
+    void unite(std::uint32_t a, std::uint32_t b);
+    // Añade un run de la fila actual y lo une con los de la fila anterior [j, prevEnd) que toca.
+    void addRun(int y, int x0, int x1, std::uint32_t border, std::size_t& j, std::size_t prevEnd);
+    // Estadísticas por componente a partir de los runs, y votación de etiquetas.
+    void accumulateBlobs(cv::Point offset);
+    void voteLabels(const cv::Mat& labels, int labelCount);
+
+    std::vector<Run> runs;
+    std::vector<std::uint32_t> parent;
+    std::vector<std::int32_t> rootToBlob;
+    std::vector<std::uint32_t> labelVotes; // results.size() x labelCount
+    std::vector<Blob> results;
+};
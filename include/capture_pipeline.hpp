@@ -0,0 +1,115 @@
+#pragma once
+
+#include "detection_governor.hpp"
+#include "latest_slot.hpp"
+#include "motion_capture.hpp"
+#include "pose_types.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+using PipelineClock = std::chrono::steady_clock;
+
+// Frame capturado por el hilo de captura.
+struct FramePacket {
+    cv::Mat image;
+    std::uint64_t frameId = 0;
+    PipelineClock::time_point captureTime{};
+};
+
+// Resultado de la detección sobre un frame.
+struct PosePacket {
+    DetectedPose pose;
+    std::uint64_t frameId = 0;
+    PipelineClock::time_point captureTime{};
+    PipelineClock::time_point detectTime{};
+};
+
+// Pipeline de tres etapas: captura -> detección -> render.
+//
+// - El hilo de captura es el único que toca el cv::VideoCapture de MotionCapture.
+// - El hilo de detección corre el detector activo (por defecto la segmentación de color
+//   de MotionCapture) sobre el frame más reciente.
+// - El hilo de render (el que llama a latestPose) nunca se bloquea: solo toma la
+//   última pose publicada, si hay una nueva.
+//
+// Las etapas se comunican con LatestSlot (SPSC sin locks, el último gana), así que
+// una cámara lenta o una detección lenta descartan frames en vez de frenar el render.
+class CapturePipeline {
+public:
+    struct Stats {
+        std::uint64_t framesCaptured = 0;
+        std::uint64_t framesDropped = 0; // Frames que la detección no llegó a procesar
+        std::uint64_t posesDetected = 0;
+        std::uint64_t posesDropped = 0;  // Poses que el render no llegó a consumir
+        std::uint64_t framesSkipped = 0; // Frames que no se detectaron por el intervalo de detección
+    };
+
+    // Se llama desde el hilo de detección con cada pose nueva, antes de publicarla al render.
+    using PoseCallback = std::function<void(const PosePacket& pose)>;
+
+    explicit CapturePipeline(MotionCapture& tracker);
+    ~CapturePipeline();
+
+    CapturePipeline(const CapturePipeline&) = delete;
+    CapturePipeline& operator=(const CapturePipeline&) = delete;
+
+    // Abre la cámara y arranca los hilos de captura y detección.
+    bool start(int cameraIndex = 0);
+    // Detiene los hilos y libera la cámara.
+    void stop();
+    // Solo con el pipeline detenido.
+    void setPoseCallback(PoseCallback callback) { poseCallback = std::move(callback); }
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // Solo desde el hilo de render. Devuelve la pose más reciente si llegó una nueva
+    // desde la última llamada; el puntero es válido hasta la siguiente llamada.
+    const PosePacket* latestPose();
+
+    Stats stats() const;
+
+    // Detecta solo uno de cada `interval` frames capturados (1 = todos). Sirve para bajar
+    // la carga de detección; PoseFilter rellena los frames intermedios en el render.
+    // Se puede cambiar desde cualquier hilo con el pipeline en marcha.
+    void setDetectionInterval(int interval) { detectionInterval.store(interval < 1 ? 1 : interval, std::memory_order_relaxed); }
+    int getDetectionInterval() const { return detectionInterval.load(std::memory_order_relaxed); }
+
+    // Detector que usa el hilo de detección: nullptr = los marcadores de color del propio
+    // MotionCapture. Se puede cambiar desde cualquier hilo con el pipeline en marcha; el
+    // detector nuevo se reinicia (reset()) antes de su primer frame, y debe seguir vivo
+    // hasta que se cambie por otro o se detenga el pipeline.
+    void setDetector(PoseDetector* detector) { activeDetector.store(detector, std::memory_order_release); }
+
+    // Gobernador del presupuesto de detección (ver DetectionGovernor). Mientras está activo
+    // controla la resolución, la morfología, el seguimiento por ventanas y el intervalo de
+    // detección (nunca detecta más a menudo que setDetectionInterval). Al desactivarlo se
+    // restauran los ajustes que tenía el detector. Se puede cambiar desde cualquier hilo.
+    // Solo gobierna los marcadores de color: con otro detector queda en pausa.
+    void setGovernorEnabled(bool enabled) { governorEnabled.store(enabled, std::memory_order_relaxed); }
+    bool isGovernorEnabled() const { return governorEnabled.load(std::memory_order_relaxed); }
+    // Solo con el pipeline detenido (presupuesto, escalera, histéresis).
+    DetectionGovernor& governor() { return detectionGovernor; }
+    DetectionGovernor::Stats governorStats() const { return detectionGovernor.stats(); }
+
+private:
+    void captureLoop();
+    void detectionLoop();
+
+    MotionCapture& tracker;
+    LatestSlot<FramePacket> frameSlot;
+    LatestSlot<PosePacket> poseSlot;
+    PoseCallback poseCallback;
+
+    DetectionGovernor detectionGovernor;
+
+    std::atomic<PoseDetector*> activeDetector{nullptr};
+    std::atomic<bool> running{false};
+    std::atomic<int> detectionInterval{1};
+    std::atomic<bool> governorEnabled{false};
+    std::atomic<std::uint64_t> framesSkipped{0};
+    std::thread captureThread;
+    std::thread detectionThread;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Detector de cambios por tiles: compara cada frame con una referencia en una cuadrícula de
+// tiles de tileSize x tileSize pixels y marca los que cambiaron, para que la detección
+// rehaga solo esos tiles y reutilice el resto.
+//
+// La comparación es una suma de diferencias absolutas (SSE2 psadbw) en grupos de 8 bytes
+// consecutivos de cada fila: un tile cambió si algún grupo supera `threshold`. Con el ruido
+// normal de una cámara la suma de un grupo queda muy por debajo del umbral, mientras que el
+// borde de un marcador que se mueve la supera de sobra. Se usa el máximo por grupo y no la
+// media del tile para que un cambio pequeño dentro de un tile grande no se diluya.
+//
+// La referencia de cada tile es el contenido que tenía la última vez que se procesó (commit),
+// no el frame anterior: un movimiento lento que no supera el umbral de un frame al siguiente
+// se acumula hasta que lo supera, así que nunca se pierde.
+class ChangeGate {
+public:
+    int tileSize = 32;
+    int threshold = 96; // Suma de |diferencias| de 8 bytes (12 por byte de media)
+
+    // Compara `frame` con la referencia y marca los tiles cambiados. Sin referencia (o si
+    // cambió el tamaño) marca todos.
+    void detect(const cv::Mat& frame);
+    // Marca también los tiles que tocan `rect` (coordenadas del frame).
+    void markDirty(const cv::Rect& rect);
+    // Copia los tiles marcados de `frame` a la referencia.
+    void commit(const cv::Mat& frame);
+    // Olvida la referencia: el siguiente detect() marca todos los tiles.
+    void reset() { hasReference = false; }
+
+    int gridCols() const { return cols; }
+    int gridRows() const { return rows; }
+    bool isDirty(int tx, int ty) const { return flags[static_cast<std::size_t>(ty) * cols + tx] != 0; }
+    int dirtyCount() const { return dirty; }
+    double dirtyFraction() const { return cols * rows > 0 ? static_cast<double>(dirty) / (cols * rows) : 1.0; }
+    // Rectángulo del tile en coordenadas del frame (los del borde pueden ser más pequeños).
+    cv::Rect tileRect(int tx, int ty) const;
+
+private:
+    bool tileChanged(const cv::Mat& frame, const cv::Rect& rect) const;
+
+    cv::Mat reference;
+    bool hasReference = false;
+    cv::Size frameSize;
+    int cols = 0;
+    int rows = 0;
+    int dirty = 0;
+    std::vector<std::uint8_t> flags;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Rango HSV con la misma convención que cv::inRange sobre una imagen COLOR_BGR2HSV
+// (H en [0, 180), S y V en [0, 255], límites inclusivos). Si hMin > hMax el rango de
+// tono da la vuelta por 0 (útil para el rojo, p. ej. 170..10).
+struct HsvRange {
+    int hMin = 0, hMax = 179;
+    int sMin = 0, sMax = 255;
+    int vMin = 0, vMax = 255;
+
+    bool contains(int h, int s, int v) const {
+        bool hueInside = hMin <= hMax ? (h >= hMin && h <= hMax) : (h >= hMin || h <= hMax);
+        return hueInside && s >= sMin && s <= sMax && v >= vMin && v <= vMax;
+    }
+
+    bool operator==(const HsvRange& other) const {
+        return hMin == other.hMin && hMax == other.hMax &&
+               sMin == other.sMin && sMax == other.sMax &&
+               vMin == other.vMin && vMax == other.vMax;
+    }
+    bool operator!=(const HsvRange& other) const { return !(*this == other); }
+};
+
+// Tabla de búsqueda BGR cuantizado -> etiqueta de color. Sustituye a cvtColor(BGR2HSV) +
+// un inRange por color: cada pixel BGR se clasifica directamente con una sola lectura en
+// la tabla, sin imagen HSV intermedia y sin importar cuántos colores haya.
+//
+// La etiqueta es 0 para el fondo e i + 1 para el rango i; si un color cae en varios rangos
+// gana el primero. Cada canal se cuantiza a kBitsPerChannel bits (32 niveles), así que la
+// tabla ocupa 32 KB y cabe en la caché L1. Cada celda se clasifica según el color de su
+// centro, de modo que los pixels justo en el borde de un rango pueden diferir de inRange.
+class ColorLut {
+public:
+    static constexpr int kBitsPerChannel = 5;
+    static constexpr int kLevels = 1 << kBitsPerChannel;
+    static constexpr std::size_t kTableSize = std::size_t(1) << (3 * kBitsPerChannel);
+    static constexpr std::size_t kMaxRanges = 254;
+
+    ColorLut();
+
+    // Reconstruye la tabla solo si los rangos cambiaron. Devuelve true si se reconstruyó.
+    bool update(const std::vector<HsvRange>& ranges);
+
+    // Clasifica un frame CV_8UC3 (BGR) en una imagen de etiquetas CV_8UC1.
+    // `labels` se reutiliza si ya tiene el tamaño correcto.
+    void classify(const cv::Mat& bgr, cv::Mat& labels) const;
+
+    // Igual que classify, pero solo lee un pixel de cada `step` en cada eje: `labels` queda de
+    // ceil(cols / step) x ceil(rows / step) y el pixel (x, y) corresponde a (x * step, y * step).
+    // Es el nivel grueso de la detección piramidal (sin promediar, como un resize NEAREST).
+    void classifyStrided(const cv::Mat& bgr, cv::Mat& labels, int step) const;
+
+    std::size_t rangeCount() const { return currentRanges.size(); }
+
+private:
+    void rebuild();
+
+    // kTableSize entradas + 3 bytes de relleno para las lecturas de 32 bits del gather AVX2.
+    std::vector<std::uint8_t> table;
+    std::vector<HsvRange> currentRanges;
+    bool built = false;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "animation_clip.hpp"
+#include "stick_figure.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <string>
+
+// Clips de la demostración. Se cargan de <directorio>/idle.clip y <directorio>/wave.clip;
+// si un archivo falta o no es válido se usa la versión precalculada de la animación
+// original (misma forma, muestreada una sola vez al arrancar).
+struct DemoClips {
+    AnimationClip idle; // Reposo: balanceo del torso, brazos abajo
+    AnimationClip wave; // Saludo con los dos brazos
+};
+
+DemoClips loadDemoClips(const std::string& directory = "assets/clips");
+
+// Versiones precalculadas (ciclo de 2*pi segundos).
+AnimationClip bakeIdleClip();
+AnimationClip bakeWaveClip();
+
+// Coloca la figura en la pose del saludo en `time`, centrada en la ventana. Evalúa el clip
+// precalculado (sin trigonometría por frame).
+void animateDemoFigure(StickFigure& figure, float time, sf::Vector2u windowSize);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "motion_capture.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Un escalón de calidad de la detección: los ajustes de MotionCapture que lo definen y
+// cada cuántos frames de cámara se detecta.
+struct DetectionQuality {
+    const char* name;
+    int pyramidScale;
+    int erodeIterations;
+    int dilateIterations;
+    bool roiTracking;
+    int fullScanInterval;  // Con roiTracking: detecciones entre escaneos completos del frame
+    int detectionInterval;
+};
+
+// Gobernador del presupuesto de detección: mide cada detección y baja o sube por una
+// escalera de calidad (de mejor a más barata) para que el coste por frame de cámara quede
+// dentro de budgetMs.
+//
+// El coste por frame es el tiempo de la detección dividido por el intervalo de detección
+// (detectar 1 de cada 2 frames da el doble de tiempo a cada detección). Se sigue con una
+// media exponencial, así que un frame lento aislado no cambia el nivel:
+// - Baja un escalón cuando la media supera el presupuesto.
+// - Sube un escalón cuando la media queda por debajo de upgradeHeadroom * budgetMs durante
+//   upgradeHoldFrames detecciones seguidas. Si una subida no se sostiene (hay que volver a
+//   bajar poco después), la siguiente subida a ese escalón espera el doble, hasta 16 veces.
+// Tras cada cambio se ignoran settleFrames detecciones, que aún arrastran el nivel anterior.
+//
+// record() y apply() se llaman desde el hilo de detección; stats() desde cualquier hilo.
+class DetectionGovernor {
+public:
+    struct Stats {
+        std::uint64_t framesMeasured = 0;
+        std::uint64_t framesOverBudget = 0; // Detecciones cuyo coste por frame superó el presupuesto
+        std::uint64_t downgrades = 0;
+        std::uint64_t upgrades = 0;
+        int level = 0;                      // Índice en ladder() (0 = mejor calidad)
+        double averageMs = 0.0;             // Media del coste por frame de cámara
+    };
+
+    DetectionGovernor();
+
+    double budgetMs = 1000.0 / 60.0; // Un frame de setFramerateLimit(60)
+    double upgradeHeadroom = 0.5;
+    int upgradeHoldFrames = 60;
+    int settleFrames = 8;
+    double smoothing = 0.2;          // Peso de cada detección en la media
+
+    // Solo con el gobernador parado (antes de la primera detección o tras reset()).
+    void setLadder(std::vector<DetectionQuality> ladder);
+    const std::vector<DetectionQuality>& ladder() const { return levels; }
+
+    // Vuelve a empezar en `startLevel` sin historia (los contadores se conservan). Las
+    // primeras settleFrames detecciones, que aún calientan buffers, no cuentan para la media.
+    void reset(int startLevel = 0);
+
+    // Registra una detección que tardó `elapsed` y cubre `framesPerDetection` frames de
+    // cámara. Devuelve true si cambió el nivel (hay que volver a aplicar los ajustes).
+    bool record(std::chrono::steady_clock::duration elapsed, int framesPerDetection);
+
+    int level() const { return current; }
+    const DetectionQuality& quality() const { return levels[static_cast<std::size_t>(current)]; }
+    // Copia los ajustes del nivel actual al detector (el intervalo lo aplica quien detecta).
+    void apply(MotionCapture& tracker) const;
+
+    Stats stats() const;
+
+private:
+    void changeLevel(int next);
+
+    std::vector<DetectionQuality> levels;
+    std::vector<int> upgradePenalty; // Por escalón: la espera para subir a él es upgradeHoldFrames << penalty
+    int current = 0;
+    int settleRemaining = 0;
+    int headroomFrames = 0;
+    int framesAtLevel = 0;
+    bool upgradedIntoCurrent = false;
+    int averagedSamples = 0;
+    double average = 0.0;
+
+    std::atomic<std::uint64_t> measured{0};
+    std::atomic<std::uint64_t> overBudget{0};
+    std::atomic<std::uint64_t> downgradeCount{0};
+    std::atomic<std::uint64_t> upgradeCount{0};
+    std::atomic<int> publishedLevel{0};
+    std::atomic<double> publishedAverage{0.0};
+};
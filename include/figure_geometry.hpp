@@ -0,0 +1,58 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+
+// Estructura para representar un hueso, conectando dos articulaciones
+struct Bone {
+    JointID joint1;
+    JointID joint2;
+    sf::Color color;
+    float thickness;
+
+    constexpr Bone(JointID j1, JointID j2, sf::Color c = sf::Color(0, 0, 0), float t = 2.f)
+        : joint1(j1), joint2(j2), color(c), thickness(t) {}
+};
+
+// Topología del esqueleto, fija en tiempo de compilación.
+inline constexpr std::array<Bone, 15> kBones = {{
+    {JointID::HEAD, JointID::NECK, sf::Color(0, 0, 0), 3.f},
+    {JointID::NECK, JointID::TORSO_TOP},
+    {JointID::TORSO_TOP, JointID::HIP_CENTER, sf::Color(100, 100, 100), 5.f},
+
+    {JointID::NECK, JointID::L_SHOULDER},
+    {JointID::L_SHOULDER, JointID::L_ELBOW},
+    {JointID::L_ELBOW, JointID::L_WRIST},
+
+    {JointID::NECK, JointID::R_SHOULDER},
+    {JointID::R_SHOULDER, JointID::R_ELBOW},
+    {JointID::R_ELBOW, JointID::R_WRIST},
+
+    {JointID::HIP_CENTER, JointID::L_HIP},
+    {JointID::L_HIP, JointID::L_KNEE},
+    {JointID::L_KNEE, JointID::L_ANKLE},
+
+    {JointID::HIP_CENTER, JointID::R_HIP},
+    {JointID::R_HIP, JointID::R_KNEE},
+    {JointID::R_KNEE, JointID::R_ANKLE},
+}};
+
+// Generación de la geometría de una figura como triángulos, para dibujar muchas figuras
+// (o una sola) con una única llamada de dibujo sobre un buffer persistente.
+namespace figure_geometry {
+
+constexpr std::size_t kCircleSegments = 8;
+constexpr float kJointRadius = 4.f;
+constexpr std::size_t kVerticesPerBone = 6;                       // Un quad = 2 triángulos
+constexpr std::size_t kVerticesPerJoint = 3 * kCircleSegments;    // Abanico de triángulos
+constexpr std::size_t kVerticesPerFigure = kBones.size() * kVerticesPerBone + kJointCount * kVerticesPerJoint;
+
+// Escribe los kVerticesPerFigure vértices de una figura en `out`: primero los huesos y
+// encima las articulaciones. La posición de la articulación j es (xs[j * stride], ys[j * stride]),
+// para poder leer tanto un array de sf::Vector2f como un layout de estructura de arrays.
+// `scale` escala el grosor de los huesos y el radio de las articulaciones.
+void writeFigure(const float* xs, const float* ys, std::size_t stride, sf::Vertex* out, float scale = 1.f);
+
+} // namespace figure_geometry
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+// Erosión y dilatación de imágenes de etiquetas CV_8UC1 con los núcleos elípticos que usa
+// la detección (getStructuringElement(MORPH_ELLIPSE) de 3x3 o 5x5), sin reservar memoria
+// por frame: cv::erode/cv::dilate crean su FilterEngine y sus buffers en cada llamada.
+//
+// Esas elipses son la unión de dos rectángulos centrados (5x5 = 5x3 ∪ 1x5, 3x3 = 3x1 ∪ 1x3),
+// y el mínimo (o máximo) sobre una unión es el mínimo de los mínimos de cada rectángulo,
+// que a su vez son separables. El resultado es idéntico al de OpenCV con el borde por
+// defecto (los pixels fuera de la imagen no cuentan).
+class LabelMorphology {
+public:
+    // kernelSize: 3 o 5. `labels` se modifica en el sitio; puede ser una vista no continua.
+    void erode(cv::Mat& labels, int kernelSize, int iterations = 1);
+    void dilate(cv::Mat& labels, int kernelSize, int iterations = 1);
+
+private:
+    template <typename Op>
+    void apply(cv::Mat& labels, int kernelSize, Op op);
+
+    cv::Mat horizontalStorage; // Pasada horizontal del rectángulo ancho
+    cv::Mat sourceStorage;     // Copia de la entrada (la salida se escribe sobre `labels`)
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Buffer triple sin locks para un productor y un consumidor (SPSC) con
+// política "el último gana": el productor nunca espera al consumidor y, si el
+// consumidor no alcanzó a leer un valor, ese valor se descarta y se cuenta.
+//
+// Los tres buffers se reservan una sola vez; el productor escribe siempre en
+// su buffer privado (writeBuffer), lo publica con publish() y el consumidor lo
+// toma con consume() + readBuffer(). Nunca se copian los datos: solo se
+// intercambian índices.
+template <typename T>
+class LatestSlot {
+public:
+    LatestSlot() = default;
+    LatestSlot(const LatestSlot&) = delete;
+    LatestSlot& operator=(const LatestSlot&) = delete;
+
+    // Permite pre-reservar memoria en los tres buffers (solo antes de arrancar los hilos).
+    template <typename F>
+    void preallocate(F&& init) {
+        for (auto& buffer : buffers) {
+            init(buffer);
+        }
+    }
+
+    // --- Lado del productor ---
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    void publish() {
+        std::uint8_t previous = shared.exchange(static_cast<std::uint8_t>(writeIndex | kFreshBit),
+                                                std::memory_order_acq_rel);
+        if (previous & kFreshBit) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        writeIndex = previous & kIndexMask;
+        published.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // --- Lado del consumidor ---
+    // Devuelve true si había un valor nuevo; en ese caso readBuffer() pasa a apuntar a él.
+    bool consume() {
+        if ((shared.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+            return false;
+        }
+        std::uint8_t previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & kIndexMask;
+        return true;
+    }
+
+    // true si hay un valor publicado que el consumidor todavía no tomó (cualquier hilo).
+    bool hasFresh() const { return (shared.load(std::memory_order_acquire) & kFreshBit) != 0; }
+
+    T& readBuffer() { return buffers[readIndex]; }
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+    // --- Contadores (se pueden leer desde cualquier hilo) ---
+    std::uint64_t publishedCount() const { return published.load(std::memory_order_relaxed); }
+    std::uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint8_t kFreshBit = 0x4;
+    static constexpr std::uint8_t kIndexMask = 0x3;
+
+    std::array<T, 3> buffers{};
+    alignas(64) std::uint8_t writeIndex = 0; // Solo lo toca el productor
+    alignas(64) std::uint8_t readIndex = 1;  // Solo lo toca el consumidor
+    alignas(64) std::atomic<std::uint8_t> shared{2};
+    alignas(64) std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> dropped{0};
+};
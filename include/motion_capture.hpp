@@ -1,8 +1,16 @@
 #pragma once
 
+#include "blob_extractor.hpp"
+#include "color_lut.hpp"
+#include "bit_mask.hpp"
+#include "change_gate.hpp"
+#include "pose_detector.hpp"
+#include "pose_types.hpp"
 #include <opencv2/opencv.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 // Estructura para los datos de los marcadores detectados (no se usa directamente en getMarkerPositions ahora)
 // struct DetectedMarker {
@@ -10,37 +18,183 @@
 //     sf::Vector2f screenPosition;
 // };
 
-class MotionCapture {
+// Un tick de captura: el frame se lee de la cámara una sola vez, se espeja en el sitio
+// sobre un buffer persistente y la detección y la vista de debug trabajan sobre él.
+struct FrameContext {
+    cv::Mat frame;           // Frame espejado (se reutiliza entre ticks)
+    DetectedPose pose;       // Pose detectada en `frame`
+    std::uint64_t tick = 0;  // Número de ticks capturados con este contexto
+    bool valid = false;      // false si la lectura falló
+};
+
+// Color de un marcador y la articulación que representa.
+struct MarkerColor {
+    JointID joint;
+    HsvRange range;
+};
+
+// Detector de marcadores de color (PoseDetector "color"); además gestiona la cámara.
+class MotionCapture : public PoseDetector {
 public:
     MotionCapture();
-    ~MotionCapture();
+    ~MotionCapture() override;
+
+    const char* name() const override { return "color"; }
 
     bool initializeCamera(int cameraIndex = 0);
     void releaseCamera();
     bool isCameraOpen() const;
 
-    // Devuelve un vector de posiciones 2D de los objetos azules detectados.
-    // El orden en el vector puede depender de cómo OpenCV encuentre los contornos.
-    std::vector<sf::Vector2f> getBlueObjectPositions();
+    // Captura un frame y devuelve la posición de cada articulación con marcador, indexada
+    // por JointID. Equivale a captureTick() sobre el contexto interno.
+    DetectedPose getMarkerPositions();
+
+    // Un tick completo en el hilo que llama: una lectura de cámara + detección, todo sobre
+    // los buffers de `context`. En régimen estable no reserva memoria.
+    bool captureTick(FrameContext& context);
+
+    // Lee el siguiente frame de la cámara y lo espeja, reutilizando el buffer de `frame`.
+    // Bloquea hasta que la cámara entrega el frame.
+    bool readFrame(cv::Mat& frame);
 
-    // Para mostrar la ventana de OpenCV con la máscara de color (opcional, para debug)
-    void displayDebugCameraView(bool showMask = false);
-    cv::Mat getCurrentFrame(); // Para obtener el frame si necesitas procesarlo fuera
+    // Detecta los marcadores de color en un frame ya capturado (sin tocar la cámara).
+    // Todos los colores se clasifican en una sola pasada; cada color da como mucho un
+    // centroide (el objeto más grande de ese color) para su articulación.
+    // Usa los buffers internos de trabajo, así que solo debe llamarse desde un hilo a la vez.
+    void detectMarkers(const cv::Mat& frame, DetectedPose& pose);
+    void detect(const cv::Mat& frame, DetectedPose& pose) override { detectMarkers(frame, pose); }
 
-    // Rangos HSV para el color azul (puedes ajustarlos)
-    // Estos son solo ejemplos, necesitarás afinarlos.
-    // Para azul: H: 100-130, S: 150-255, V: 50-255 (aproximado)
-    int blue_H_min = 100, blue_H_max = 130;
-    int blue_S_min = 100, blue_S_max = 255; // Aumentado el mínimo de S para colores más saturados
-    int blue_V_min = 100, blue_V_max = 255; // Aumentado el mínimo de V para colores más brillantes
+    // Para mostrar la ventana de OpenCV con la máscara de color (opcional, para debug).
+    // Usa el frame, la máscara y la pose de un tick ya procesado (por defecto el del último
+    // getMarkerPositions()): no lee otro frame ni vuelve a detectar. Debe llamarse justo
+    // después del tick y en el mismo hilo (no con CapturePipeline en marcha).
+    void displayDebugCameraView(bool showMask = false) { displayDebugCameraView(lastTick, showMask); }
+    void displayDebugCameraView(const FrameContext& context, bool showMask = false);
+    // Frame del último getMarkerPositions() (sin leer de la cámara). Es el buffer interno:
+    // se sobrescribe en el siguiente tick, así que hay que clonarlo para conservarlo.
+    const cv::Mat& getCurrentFrame() const { return lastTick.frame; }
+
+    // Tabla de colores de marcador: cada rango HSV se asocia directamente a una articulación,
+    // así la identidad no depende del orden en que se encuentren los objetos.
+    // Estos son solo ejemplos, necesitarás afinarlos para tus cintas y tu iluminación.
+    // Si cambian, la tabla de clasificación se reconstruye automáticamente en el siguiente frame.
+    std::vector<MarkerColor> markerColors = {
+        {JointID::HEAD,    {100, 130, 100, 255, 100, 255}}, // Azul
+        {JointID::L_WRIST, { 40,  80, 100, 255,  70, 255}}, // Verde
+        {JointID::R_WRIST, {170,  10, 120, 255,  70, 255}}, // Rojo (el tono da la vuelta por 0)
+    };
 
     // Mínima área de contorno para ser considerado un objeto
     double minContourArea = 100.0;
 
+    // Modo de seguimiento: tras un escaneo completo, cada marcador se busca solo en una
+    // ventana alrededor de su posición predicha. Si algún marcador se pierde, o cada
+    // fullScanInterval frames, se vuelve a escanear el frame completo.
+    bool roiTrackingEnabled = true;
+    int fullScanInterval = 30;
+    int roiMargin = 24; // Pixels añadidos alrededor del bounding box predicho
+
+    // Fuerza un escaneo completo en el siguiente frame (por ejemplo, al cambiar de cámara).
+    void resetTracking();
+    void reset() override { resetTracking(); }
+
+    // Detección piramidal: 1 = resolución completa; 2 o 4 = la clasificación, la morfología
+    // y las componentes conexas se hacen sobre un frame submuestreado (1/4 o 1/16 de los
+    // pixels) y después cada centroide se refina con los momentos de una ventana pequeña a
+    // resolución completa alrededor del objeto, así que se conserva la precisión subpixel.
+    int pyramidScale = 1;
+
+    // Limpieza morfológica del primer plano: iteraciones de erosión (quita el ruido) y de
+    // dilatación (cierra huecos). Menos iteraciones abaratan la detección a costa de objetos
+    // algo más pequeños y ruidosos.
+    int erodeIterations = 1;
+    int dilateIterations = 2;
+
+    // Escaneo completo incremental: el frame se compara con el del escaneo anterior en tiles
+    // (ChangeGate) y la clasificación, la morfología y las componentes conexas se rehacen solo
+    // en los tiles que cambiaron o que contienen un marcador seguido; los objetos del resto
+    // del frame se reutilizan. Si cambia más de changeMaxDirtyFraction de los tiles, se hace
+    // el escaneo completo normal.
+    bool changeGateEnabled = true;
+    int changeTileSize = 32;             // Pixels; se redondea a un múltiplo de pyramidScale
+    int changeThreshold = 96;            // Ver ChangeGate::threshold
+    double changeMaxDirtyFraction = 0.5;
+
 
 private:
+    // Objeto de color encontrado en una región del frame (coordenadas del frame completo).
+    struct DetectedBlob {
+        sf::Vector2f center;
+        cv::Rect bounds;
+        double area;
+        int colorIndex;   // Índice en markerColors
+        float confidence; // Fracción de los pixels con color del objeto que tienen ese color
+    };
+
+    // Marcador seguido entre frames (uno por color de markerColors).
+    struct MarkerTrack {
+        bool active = false;
+        sf::Vector2f position;
+        sf::Vector2f velocity;
+        cv::Rect bounds;
+        double area = 0.0;
+        float confidence = 0.f;
+    };
+
+    // Componente del último escaneo incremental (coordenadas del nivel de detección) y el
+    // objeto que se reporta para ella, si pasa el filtro de área.
+    struct SceneBlob {
+        cv::Rect bounds;
+        bool reported;
+        DetectedBlob detected;
+    };
+
+    // Umbral + limpieza morfológica + componentes conexas sobre `region`; añade los objetos a `blobs`.
+    void scanRegion(const cv::Mat& frame, const cv::Rect& region, std::vector<DetectedBlob>& blobs);
+    // Escaneo completo reutilizando lo que no cambió desde el anterior (ver changeGateEnabled).
+    void scanChangedTiles(const cv::Mat& frame, std::vector<DetectedBlob>& blobs);
+    // Convierte una componente (coordenadas del nivel de detección, relativas a `origin` del
+    // frame) en un objeto. Devuelve false si no pasa el filtro de área o no tiene color.
+    bool toDetectedBlob(const cv::Mat& frame, const Blob& blob, cv::Point origin, DetectedBlob& out);
+    // Centroide a resolución completa de los pixels con etiqueta `label` dentro de `window`.
+    // Si no hay ninguno devuelve `fallback`.
+    sf::Vector2f refineCentroid(const cv::Mat& frame, const cv::Rect& window, int label, sf::Vector2f fallback);
+    void fullScan(const cv::Mat& frame);
+    bool trackInWindows(const cv::Mat& frame);
+
     cv::VideoCapture cap;
-    cv::Mat hsvFrame;
-    cv::Mat colorMask;
+    ColorLut colorLut; // BGR -> etiqueta de color en una sola pasada (reemplaza cvtColor + inRange)
+    std::vector<HsvRange> rangeScratch;
+    cv::Mat colorMask; // Imagen de etiquetas: 0 fondo, i + 1 para markerColors[i] (vista de colorMaskStorage)
+    cv::Mat colorMaskStorage;
+    BitMask foregroundMask;    // Primer plano de colorMask, 1 bit por pixel, limpiado con morfología
+    BitMorphology morphology;  // Erosión/dilatación palabra a palabra, sin reservas por frame
+    BlobExtractor blobExtractor; // Reemplaza findContours + contourArea + moments
+    cv::Mat refineMask;          // Etiquetas a resolución completa de la ventana de refinamiento
+    cv::Mat refineMaskStorage;
+
+    // Estado del escaneo incremental: etiquetas, primer plano limpio y componentes del frame
+    // completo en el nivel de detección.
+    ChangeGate changeGate;
+    cv::Mat sceneLabels;
+    BitMask sceneForeground;
+    BitMask regionMask;          // Región de trabajo de la morfología / extracción incremental
+    std::vector<SceneBlob> sceneBlobs;
+    std::vector<cv::Rect> dirtyRects;
+    std::vector<cv::Rect> extractRects;
+    std::vector<int> tileStack;
+    std::vector<std::uint8_t> tileVisited;
+    int sceneScale = 0;          // pyramidScale del estado guardado; 0 = no hay estado
+    int sceneErode = 0;          // Iteraciones de morfología con las que se limpió sceneForeground
+    int sceneDilate = 0;
+
+    FrameContext lastTick;       // Contexto de getMarkerPositions() y de la vista de debug
+    cv::Mat frameLabels;         // Etiquetas de todo el frame de la última detección (vista de colorMask o sceneLabels), o vacía
+    cv::Mat debugMaskStorage;
+    cv::Mat debugFrame;
+
+    std::vector<MarkerTrack> tracks;
+    std::vector<DetectedBlob> blobScratch;
+    int framesSinceFullScan = 0;
     // Otros miembros necesarios para OpenCV
 };
\ No newline at end of file
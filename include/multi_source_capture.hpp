@@ -0,0 +1,106 @@
+#pragma once
+
+#include "capture_pipeline.hpp"
+#include "latest_slot.hpp"
+#include "motion_capture.hpp"
+#include "work_stealing_pool.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Una fuente de video: una cámara (path vacío) o un archivo.
+struct CaptureSourceConfig {
+    std::string path;      // Archivo de video; vacío = cámara cameraIndex
+    int cameraIndex = 0;
+    bool mirror = true;    // Espejar como en el modo en vivo
+    int pyramidScale = 1;  // Ver MotionCapture::pyramidScale
+    // Solo archivos. realtime: se leen al ritmo de su fps, como una cámara (y con loop se
+    // repiten). Sin realtime se procesan todos los frames lo más rápido posible, sin
+    // descartar ninguno (la lectura espera a que la detección tome el frame anterior).
+    bool realtime = true;
+    bool loop = true;
+};
+
+// Captura de varias fuentes en un solo proceso.
+//
+// Cada fuente tiene su propio hilo de lectura (cv::VideoCapture::read bloquea hasta el
+// siguiente frame de la cámara) y su propio detector, y le pasa los frames a la detección
+// con un LatestSlot, igual que CapturePipeline. Las detecciones de todas las fuentes corren
+// en un WorkStealingPool compartido: cada fuente tiene como mucho una tarea de detección
+// en marcha o en cola, que procesa un frame y se vuelve a encolar si ya llegó el siguiente.
+// Así los frames de una misma fuente se detectan en orden (y el estado de seguimiento de su
+// detector nunca se usa desde dos hilos a la vez), mientras fuentes distintas se reparten
+// los núcleos.
+class MultiSourceCapture {
+public:
+    struct SourceStats {
+        std::uint64_t framesCaptured = 0;
+        std::uint64_t framesDropped = 0; // Frames que la detección no llegó a procesar
+        std::uint64_t posesDetected = 0;
+        std::uint64_t posesDropped = 0;  // Poses que el render no llegó a consumir
+    };
+
+    // Se llama desde los hilos del grupo con cada pose detectada, en orden de frame dentro
+    // de cada fuente (nunca dos llamadas a la vez para la misma fuente).
+    using PoseCallback = std::function<void(std::size_t source, const PosePacket& pose)>;
+
+    // threadCount: hilos de detección compartidos (0 = número de núcleos).
+    explicit MultiSourceCapture(unsigned threadCount = 0);
+    ~MultiSourceCapture();
+
+    MultiSourceCapture(const MultiSourceCapture&) = delete;
+    MultiSourceCapture& operator=(const MultiSourceCapture&) = delete;
+
+    // Solo con la captura detenida. Devuelve el índice de la fuente.
+    std::size_t addSource(const CaptureSourceConfig& config);
+    std::size_t sourceCount() const { return sources.size(); }
+    void setPoseCallback(PoseCallback callback) { poseCallback = std::move(callback); }
+
+    // Abre todas las fuentes y arranca la lectura. Si alguna no se puede abrir no arranca ninguna.
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Espera a que las fuentes sin loop lleguen al final del archivo y a que se detecten
+    // todos sus frames leídos. No termina si alguna fuente es una cámara o tiene loop.
+    void waitUntilDrained();
+
+    // Solo desde un hilo (el de render): pose más reciente de la fuente si llegó una nueva
+    // desde la última llamada; el puntero es válido hasta la siguiente llamada.
+    const PosePacket* latestPose(std::size_t source);
+
+    SourceStats stats(std::size_t source) const;
+    WorkStealingPool::Stats poolStats() const { return pool.stats(); }
+    unsigned threadCount() const { return pool.threadCount(); }
+
+private:
+    struct Source {
+        CaptureSourceConfig config;
+        std::size_t index = 0;
+        cv::VideoCapture capture;
+        MotionCapture detector;
+        LatestSlot<FramePacket> frameSlot;
+        LatestSlot<PosePacket> poseSlot;
+        std::thread readThread;
+        std::atomic<bool> jobScheduled{false};
+        std::atomic<bool> readFinished{false};
+    };
+
+    void readLoop(Source& source);
+    // Encola la detección de la fuente si no tiene ya una tarea pendiente.
+    void scheduleDetection(Source& source);
+    void detectionJob(std::size_t index);
+
+    std::vector<std::unique_ptr<Source>> sources;
+    PoseCallback poseCallback;
+    std::atomic<bool> reading{false};
+    bool running = false;
+    // Último miembro: se destruye primero, así sus tareas terminan antes que las fuentes.
+    WorkStealingPool pool;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opciones del modo sin ventana (--input).
+struct OfflineOptions {
+    std::string inputPath;
+    std::string outputPath = "poses.csv"; // Con extensión .ptrk se escribe una pista de pose binaria
+    unsigned workers = 0;              // 0 = número de núcleos
+    bool mirror = true;                // Espejar como en el modo en vivo
+    int pyramidScale = 1;              // Ver MotionCapture::pyramidScale
+    std::size_t minChunkFrames = 120;  // Tramos más cortos no compensan el coste de buscar
+};
+
+// Resultado de la detección para un frame del archivo.
+struct OfflineFrameResult {
+    std::uint64_t frameIndex = 0;
+    double timestampMs = 0.0;
+    DetectedPose pose;
+};
+
+// Procesa un video grabado sin ventana ni cámara. El archivo se divide en tramos de
+// frames consecutivos que se decodifican y detectan en hilos distintos (cada hilo con su
+// propio cv::VideoCapture y su propio detector) y los resultados se unen en orden de frame.
+class OfflineProcessor {
+public:
+    explicit OfflineProcessor(const OfflineOptions& options);
+
+    // Procesa el archivo completo y escribe el resultado. Devuelve false si hubo un error.
+    bool run();
+
+    const std::vector<OfflineFrameResult>& results() const { return frames; }
+
+private:
+    struct Chunk {
+        std::uint64_t firstFrame = 0;
+        std::uint64_t endFrame = 0; // Exclusivo; 0 = hasta el final del archivo
+        std::vector<OfflineFrameResult> results;
+        bool ok = true;             // false solo si no se pudo abrir el video
+    };
+
+    void processChunk(Chunk& chunk) const;
+    bool writeCsv() const;
+    bool writePoseTrack() const;
+
+    OfflineOptions options;
+    double fps = 30.0;
+    std::vector<OfflineFrameResult> frames;
+};
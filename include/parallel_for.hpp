@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Grupo de hilos persistente para bucles paralelos cortos (se usa cada frame, así que
+// los hilos se crean una sola vez). El hilo que llama a run() también trabaja.
+class ParallelFor {
+public:
+    // threadCount incluye al hilo que llama; 0 = número de núcleos.
+    explicit ParallelFor(unsigned threadCount = 0);
+    ~ParallelFor();
+
+    ParallelFor(const ParallelFor&) = delete;
+    ParallelFor& operator=(const ParallelFor&) = delete;
+
+    // Reparte [0, count) en bloques de `grain` elementos y llama a fn(begin, end) para cada
+    // bloque desde todos los hilos. Bloquea hasta que se procesan todos los bloques.
+    void run(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn);
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+private:
+    void workerLoop();
+    void processChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::uint64_t generation = 0;
+    std::size_t busyWorkers = 0;
+    bool stopping = false;
+
+    // Trabajo actual (se escribe bajo el mutex antes de despertar a los hilos)
+    const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+    std::size_t jobCount = 0;
+    std::size_t jobGrain = 1;
+    std::atomic<std::size_t> nextIndex{0};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "figure_geometry.hpp"
+#include "parallel_for.hpp"
+#include "pose_types.hpp"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Multitud de figuras animadas por la misma pose fuente (modo "crowd").
+//
+// Las coordenadas se guardan como estructura de arrays: para cada articulación, las x (e y)
+// de todas las figuras son contiguas, así el retargeting (offset + escala) se aplica con
+// SIMD a muchas figuras a la vez. Cada figura tiene su propio desfase (phase), en frames,
+// sobre un historial circular de poses fuente, para que la multitud no se mueva al unísono.
+// Todas las figuras se emiten a un único sf::VertexArray y se dibujan con una sola llamada.
+class PoseBatch {
+public:
+    static constexpr std::size_t kHistoryLength = 64;
+
+    PoseBatch() = default;
+
+    void reserve(std::size_t figureCount);
+    void clear();
+    // Añade una figura; `phase` es el retraso en frames respecto a la pose fuente (< kHistoryLength).
+    std::size_t addFigure(sf::Vector2f offset, float scale, std::uint32_t phase);
+    std::size_t size() const { return figureCount; }
+
+    // Añade la pose fuente de este frame al historial. Se guarda relativa a `anchor`
+    // (normalmente HIP_CENTER), así el offset de cada figura es la posición de su cadera.
+    void pushSourcePose(const std::array<sf::Vector2f, kJointCount>& joints, JointID anchor = JointID::HIP_CENTER);
+
+    // Retargeting de todas las figuras y generación de vértices, repartido entre los hilos.
+    void update(ParallelFor& workers);
+
+    void draw(sf::RenderTarget& target) const;
+
+    float jointX(std::size_t figure, JointID joint) const { return xs[jointIndex(joint) * stride + figure]; }
+    float jointY(std::size_t figure, JointID joint) const { return ys[jointIndex(joint) * stride + figure]; }
+
+private:
+    void resizeStorage(std::size_t newStride);
+    void retargetRange(std::size_t begin, std::size_t end);
+    void emitRange(std::size_t begin, std::size_t end);
+
+    std::size_t figureCount = 0;
+    std::size_t stride = 0; // Capacidad por articulación (múltiplo del ancho SIMD)
+
+    // Parámetros por figura
+    std::vector<float> offsetX, offsetY, scales;
+    std::vector<std::uint32_t> phases;
+
+    // Articulaciones en layout SoA: xs[joint * stride + figura]
+    std::vector<float> xs, ys;
+
+    // Historial circular de poses fuente (relativas al ancla)
+    std::array<std::array<float, kJointCount>, kHistoryLength> historyX{};
+    std::array<std::array<float, kJointCount>, kHistoryLength> historyY{};
+    std::size_t historyHead = 0;
+
+    sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+
+// Detector de pose sobre un frame ya capturado (BGR, espejado como en el modo en vivo):
+// devuelve las articulaciones que encuentra, indexadas por JointID y en coordenadas del
+// frame, con su confianza; las que no encuentra quedan con confianza 0.
+//
+// Las implementaciones guardan estado entre frames (seguimiento, modelo del fondo) y usan
+// buffers internos, así que cada instancia solo debe usarse desde un hilo a la vez.
+class PoseDetector {
+public:
+    virtual ~PoseDetector() = default;
+
+    // Nombre estable ("color", "silhouette") para la línea de comandos, logs y el bench.
+    virtual const char* name() const = 0;
+    virtual void detect(const cv::Mat& frame, DetectedPose& pose) = 0;
+    // Olvida el estado entre frames (al cambiar de cámara o de detector).
+    virtual void reset() = 0;
+};
+
+// Crea un detector por nombre: "color" (marcadores de color, MotionCapture, sin cámara) o
+// "silhouette" (sin marcadores, SilhouetteDetector). nullptr si el nombre no existe.
+std::unique_ptr<PoseDetector> makePoseDetector(const std::string& name);
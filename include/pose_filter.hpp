@@ -0,0 +1,58 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// Filtro temporal por articulación (alfa-beta, velocidad constante) entre la detección
+// y StickFigure. Recibe muestras con la marca de tiempo de captura y entrega la pose
+// interpolada/extrapolada al instante en que se va a presentar el frame, así que el
+// render puede ir a 60 fps aunque la cámara (o la detección) vaya a 30 fps o menos.
+//
+// Los centroides que caen fuera de la ventana de validación alrededor de la posición
+// predicha se descartan como atípicos; si se repiten varios frames seguidos se acepta
+// el salto (el marcador se movió de verdad) y el filtro se reinicia en esa posición.
+class PoseFilter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Ganancias del filtro: alpha corrige la posición, beta la velocidad.
+    float alpha = 0.85f;
+    float beta = 0.25f;
+    // Radio de validación: outlierDistance pixels más una fracción del desplazamiento esperado.
+    float outlierDistance = 80.f;
+    float outlierSpeedFactor = 0.5f;
+    int maxConsecutiveOutliers = 2;
+    // Límite de extrapolación: más allá de esto la articulación se queda quieta.
+    float maxExtrapolationSeconds = 0.1f;
+    // Sin muestras durante este tiempo, la articulación deja de emitirse (la figura la mantiene).
+    float staleSeconds = 0.5f;
+    // Retraso opcional del render: con un valor > 0 se interpola entre las dos últimas
+    // muestras filtradas en vez de extrapolar (más suave, a costa de latencia).
+    float renderDelaySeconds = 0.f;
+
+    // Incorpora una pose detectada sobre un frame capturado en `captureTime`.
+    void addSample(const DetectedPose& pose, Clock::time_point captureTime);
+    // Pose estimada para `presentTime`. Las articulaciones sin estado válido quedan con confianza 0.
+    void sample(Clock::time_point presentTime, DetectedPose& out) const;
+
+    void reset();
+    std::uint64_t rejectedCount() const { return rejected; }
+
+private:
+    struct JointState {
+        bool valid = false;
+        sf::Vector2f position;      // Estado filtrado en lastTime
+        sf::Vector2f velocity;      // Pixels por segundo
+        sf::Vector2f previousPosition;
+        Clock::time_point lastTime{};
+        Clock::time_point previousTime{};
+        float confidence = 0.f;
+        int consecutiveOutliers = 0;
+    };
+
+    std::array<JointState, kJointCount> joints{};
+    std::uint64_t rejected = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "pose_shm_reader.hpp"
+#include "pose_types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+static_assert(pose_shm::kJointCount == kJointCount, "El anillo compartido usa el orden de JointID");
+
+// Lado de escritura del anillo de poses compartido (ver pose_shm_reader.hpp). Solo un
+// proceso, y un hilo, debe publicar en cada anillo.
+class PoseShmPublisher {
+public:
+    PoseShmPublisher() = default;
+    ~PoseShmPublisher();
+
+    PoseShmPublisher(const PoseShmPublisher&) = delete;
+    PoseShmPublisher& operator=(const PoseShmPublisher&) = delete;
+
+    // Crea el anillo con slotCount ranuras; si ya existía uno con ese nombre, lo desvincula y
+    // crea otro (los lectores que lo tenían mapeado no se ven afectados). El objeto de memoria
+    // compartida no se borra al cerrar, así los lectores pueden seguir leyendo los últimos frames.
+    bool open(const std::string& name = pose_shm::kDefaultName, std::uint32_t slotCount = pose_shm::kDefaultSlotCount);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Escribe la pose en la siguiente ranura. captureTime es el instante de captura del frame.
+    void publish(const DetectedPose& pose, std::chrono::steady_clock::time_point captureTime);
+
+    std::uint64_t publishedCount() const { return published; }
+
+private:
+    pose_shm::Header* header = nullptr;
+    pose_shm::Slot* slots = nullptr;
+    std::size_t mappedSize = 0;
+    std::uint64_t published = 0;
+};
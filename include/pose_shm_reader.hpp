@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Anillo de poses en memoria compartida (shm_open; en Linux aparece en /dev/shm/<nombre>).
+//
+// Un único proceso escribe (PoseShmPublisher) y cualquier número de procesos leen. Cada
+// ranura lleva un seqlock: el escritor pone la secuencia en impar, escribe la pose y la
+// vuelve a poner en par; un lector lee la secuencia antes y después y descarta la lectura
+// si cambió. Los datos se copian de la ranura con memcpy entre las dos lecturas de la
+// secuencia y solo se usan si no cambió. Leer no hace llamadas al sistema ni toma locks:
+// una vez mapeado, todo son lecturas de memoria.
+//
+// Este archivo no depende de SFML ni de OpenCV, para que otros procesos puedan usarlo
+// solo con libpose_shm_reader.a (make shm-reader). Las articulaciones van en el orden de
+// JointID (pose_types.hpp).
+namespace pose_shm {
+
+constexpr std::uint32_t kMagic = 0x45534f50; // "POSE"
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kJointCount = 16;
+constexpr std::uint32_t kDefaultSlotCount = 256;
+constexpr const char* kDefaultName = "motion_pose";
+
+// Reloj de las marcas de tiempo: std::chrono::steady_clock en nanosegundos. En Linux es
+// CLOCK_MONOTONIC, común a todos los procesos de la máquina.
+inline std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct alignas(64) Slot {
+    std::atomic<std::uint32_t> sequence; // Impar mientras se escribe
+    std::uint32_t reserved;
+    std::uint64_t frameNumber;           // 0, 1, 2... en orden de publicación
+    std::int64_t captureTimeNs;          // Cuándo se capturó el frame de cámara
+    std::int64_t publishTimeNs;          // Cuándo se escribió en el anillo
+    float x[kJointCount];
+    float y[kJointCount];
+    float confidence[kJointCount];       // 0 = articulación no detectada
+};
+
+struct alignas(64) Header {
+    std::atomic<std::uint32_t> magic;    // Se escribe al final de la inicialización
+    std::uint32_t version;
+    std::uint32_t jointCount;
+    std::uint32_t slotCount;
+    std::uint32_t slotSize;
+    alignas(64) std::atomic<std::uint64_t> published; // Frames publicados; el último es published - 1
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "El seqlock necesita atómicos sin lock");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "El seqlock necesita atómicos sin lock");
+
+inline std::size_t mappingSize(std::uint32_t slotCount) {
+    return sizeof(Header) + static_cast<std::size_t>(slotCount) * sizeof(Slot);
+}
+
+// Copia de un frame leído del anillo.
+struct Frame {
+    std::uint64_t frameNumber = 0;
+    std::int64_t captureTimeNs = 0;
+    std::int64_t publishTimeNs = 0;
+    float x[kJointCount] = {};
+    float y[kJointCount] = {};
+    float confidence[kJointCount] = {};
+};
+
+} // namespace pose_shm
+
+// Lado de lectura. Se puede usar desde otro proceso mientras el publicador escribe.
+class PoseShmReader {
+public:
+    PoseShmReader() = default;
+    ~PoseShmReader();
+
+    PoseShmReader(const PoseShmReader&) = delete;
+    PoseShmReader& operator=(const PoseShmReader&) = delete;
+
+    // Mapea el anillo (solo lectura). Falla si no existe o si el formato no coincide.
+    bool open(const std::string& name = pose_shm::kDefaultName);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Las consultas se pueden hacer sin anillo abierto (antes de open(), si falló, o tras
+    // close()): entonces no hay frames publicados y ninguna lectura tiene éxito.
+
+    // Frames publicados hasta ahora (0 = ninguno).
+    std::uint64_t publishedCount() const { return header ? header->published.load(std::memory_order_acquire) : 0; }
+    // Primer frame que todavía puede estar en el anillo.
+    std::uint64_t oldestAvailable() const;
+    // Ranuras del anillo tal como estaba al abrirlo: todo el acceso se acota con este valor y
+    // con el tamaño mapeado, no con la cabecera compartida. Si el publicador se reinicia, crea
+    // un anillo nuevo con el mismo nombre y este lector sigue viendo el anterior (sin frames
+    // nuevos) hasta que vuelve a llamar a open().
+    std::uint32_t slotCount() const { return ringSlots; }
+
+    // Copia el frame `frameNumber`. Devuelve false si ya se sobrescribió, si todavía no se
+    // publicó o si el escritor lo estaba modificando (en ese caso se puede reintentar).
+    bool read(std::uint64_t frameNumber, pose_shm::Frame& out) const;
+    // Último frame publicado, reintentando si el escritor da la vuelta durante la lectura.
+    bool readLatest(pose_shm::Frame& out) const;
+
+    // Llama a fn(const pose_shm::Frame&) con una copia consistente del frame `frameNumber` y
+    // devuelve si la hubo (mismas condiciones que read()). La copia se hace dentro del
+    // seqlock, así fn nunca ve datos a medio escribir.
+    template <typename Fn>
+    bool visit(std::uint64_t frameNumber, Fn&& fn) const {
+        pose_shm::Frame frame;
+        if (!read(frameNumber, frame)) {
+            return false;
+        }
+        fn(static_cast<const pose_shm::Frame&>(frame));
+        return true;
+    }
+
+private:
+    const pose_shm::Header* header = nullptr;
+    const pose_shm::Slot* slots = nullptr;
+    std::size_t mappedSize = 0;
+    std::uint32_t ringSlots = 0;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "pose_types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+// Formato binario de pistas de pose (.ptrk).
+//
+//   [PoseTrackHeader: 64 bytes][PoseTrackFrame 0][PoseTrackFrame 1]...
+//
+// Todos los frames tienen el mismo tamaño (frameStride), así que el frame i está en
+// sizeof(PoseTrackHeader) + i * frameStride: acceso aleatorio O(1). Los frames llegan a la
+// frecuencia variable de la detección, así que el tiempo de cada uno es su timestampUs
+// (creciente) y frameRate solo es la frecuencia media. Cada frame guarda un
+// DetectedPose tal cual (posiciones y confianzas indexadas por JointID), de modo que al
+// reproducir se puede pasar directamente desde el archivo mapeado a StickFigure, sin copias
+// ni parseo. Los valores se guardan en el orden de bytes de la máquina (little-endian en
+// todas las plataformas soportadas).
+struct PoseTrackHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t jointCount;
+    std::uint32_t frameStride;  // Bytes por frame
+    double frameRate;           // Frames por segundo medios (el escritor la recalcula al cerrar)
+    std::uint64_t frameCount;   // Se escribe al cerrar; si es 0 se deduce del tamaño del archivo
+    std::uint8_t reserved[32];
+};
+
+struct PoseTrackFrame {
+    std::int64_t timestampUs;   // Desde el inicio de la grabación
+    DetectedPose pose;
+};
+
+static_assert(sizeof(PoseTrackHeader) == 64, "La cabecera .ptrk debe ocupar 64 bytes");
+static_assert(std::is_trivially_copyable<PoseTrackFrame>::value, "Los frames se leen directamente del archivo mapeado");
+static_assert(sizeof(PoseTrackFrame) == 8 + kJointCount * 3 * sizeof(float), "PoseTrackFrame no debe tener relleno");
+
+// Graba poses detectadas en un archivo .ptrk (escritura secuencial con buffer).
+class PoseTrackWriter {
+public:
+    PoseTrackWriter() = default;
+    ~PoseTrackWriter();
+
+    PoseTrackWriter(const PoseTrackWriter&) = delete;
+    PoseTrackWriter& operator=(const PoseTrackWriter&) = delete;
+
+    bool open(const std::string& path, double frameRate);
+    bool append(const DetectedPose& pose, std::int64_t timestampUs);
+    // Escribe en la cabecera el número final de frames y su frecuencia media (según los
+    // timestamps; la de open() queda si hay menos de dos frames) y cierra el archivo.
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+    std::uint64_t frameCount() const { return framesWritten; }
+
+private:
+    std::FILE* file = nullptr;
+    std::uint64_t framesWritten = 0;
+    std::int64_t firstTimestampUs = 0;
+    std::int64_t lastTimestampUs = 0;
+};
+
+// Lee un archivo .ptrk mapeándolo en memoria (mmap): abrir es O(1) y cada frame se lee
+// directamente de la página mapeada.
+class PoseTrackReader {
+public:
+    PoseTrackReader() = default;
+    ~PoseTrackReader();
+
+    PoseTrackReader(const PoseTrackReader&) = delete;
+    PoseTrackReader& operator=(const PoseTrackReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return mapped != nullptr; }
+    std::uint64_t frameCount() const { return frames; }
+    double frameRate() const { return header ? header->frameRate : 0.0; }
+
+    // Acceso aleatorio O(1); `index` debe ser < frameCount().
+    const PoseTrackFrame& frame(std::uint64_t index) const {
+        return *reinterpret_cast<const PoseTrackFrame*>(firstFrame + index * stride);
+    }
+    // Frame que se mostraba `seconds` después del primero: búsqueda binaria sobre los
+    // timestamps grabados (O(log n) sobre el archivo mapeado), acotada a la pista. Las pistas
+    // sin timestamps crecientes usan la frecuencia media de la cabecera.
+    std::uint64_t frameIndexAt(double seconds) const;
+    // Duración de la pista para reproducirla en bucle: del primer al último timestamp, más
+    // un intervalo medio para que el último frame también se vea.
+    double duration() const;
+
+private:
+    void* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    const PoseTrackHeader* header = nullptr;
+    const std::uint8_t* firstFrame = nullptr;
+    std::size_t stride = 0;
+    std::uint64_t frames = 0;
+    bool timed = false; // Timestamps crecientes entre el primer y el último frame
+};
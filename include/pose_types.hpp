@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+
+// Enum para identificar las articulaciones/puntos clave
+enum class JointID {
+    HEAD, NECK,
+    L_SHOULDER, L_ELBOW, L_WRIST,
+    R_SHOULDER, R_ELBOW, R_WRIST,
+    TORSO_TOP, HIP_CENTER,
+    L_HIP, L_KNEE, L_ANKLE,
+    R_HIP, R_KNEE, R_ANKLE,
+    JOINT_COUNT
+};
+
+constexpr std::size_t kJointCount = static_cast<std::size_t>(JointID::JOINT_COUNT);
+
+constexpr std::size_t jointIndex(JointID joint) { return static_cast<std::size_t>(joint); }
+
+// Nombre estable de cada articulación (para archivos de salida y logs).
+inline const char* jointName(JointID joint) {
+    static constexpr const char* kNames[kJointCount] = {
+        "HEAD", "NECK",
+        "L_SHOULDER", "L_ELBOW", "L_WRIST",
+        "R_SHOULDER", "R_ELBOW", "R_WRIST",
+        "TORSO_TOP", "HIP_CENTER",
+        "L_HIP", "L_KNEE", "L_ANKLE",
+        "R_HIP", "R_KNEE", "R_ANKLE",
+    };
+    return jointIndex(joint) < kJointCount ? kNames[jointIndex(joint)] : "UNKNOWN";
+}
+
+// Pose detectada en un frame: una posición por articulación, indexada por JointID.
+// Una confianza de 0 indica que la articulación no se detectó en este frame.
+struct DetectedPose {
+    std::array<sf::Vector2f, kJointCount> positions{};
+    std::array<float, kJointCount> confidence{};
+
+    void clear() { confidence.fill(0.f); }
+
+    void set(JointID joint, sf::Vector2f position, float jointConfidence) {
+        positions[jointIndex(joint)] = position;
+        confidence[jointIndex(joint)] = jointConfidence;
+    }
+
+    bool has(JointID joint) const { return confidence[jointIndex(joint)] > 0.f; }
+    sf::Vector2f position(JointID joint) const { return positions[jointIndex(joint)]; }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <optional>
+#include <string>
+
+// Muestra el resumen de StageProfiler (p50/p95/p99 por etapa) como texto sobre la ventana.
+// El texto se regenera dos veces por segundo para no pagar el formateo en cada frame.
+// Si no se encuentra ninguna fuente del sistema, el resumen se imprime en la consola.
+class ProfilerOverlay {
+public:
+    ProfilerOverlay();
+
+    void toggle();
+    bool isVisible() const { return visible; }
+
+    void draw(sf::RenderTarget& target);
+
+    // Texto adicional que se muestra debajo de las latencias (por ejemplo, los contadores
+    // del gobernador de detección). Se llama al regenerar el texto, no en cada frame.
+    void setStatusSource(std::function<std::string()> source) { statusSource = std::move(source); }
+
+private:
+    void refresh();
+
+    bool visible = false;
+    bool fontLoaded = false;
+    sf::Font font;
+    std::optional<sf::Text> text;
+    sf::RectangleShape background;
+    sf::Clock refreshClock;
+    std::function<std::string()> statusSource;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "label_morphology.hpp"
+#include "pose_detector.hpp"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Detector sin marcadores: estima la cabeza, las manos y los pies a partir de la silueta.
+//
+// 1. El frame se reduce workScale veces (640x480 -> 160x120) y se compara con un modelo
+//    del fondo (media por pixel, aprendida en los primeros learningFrames frames, con la
+//    escena vacía, y adaptada despacio en los pixels que no son primer plano).
+// 2. La silueta se limpia con apertura + cierre, se queda la componente más grande y se
+//    rellenan sus huecos.
+// 3. El máximo de la transformada de distancia da el centro del torso, y el adelgazamiento
+//    de Zhang-Suen da el esqueleto de un pixel de ancho. Cada extremo del esqueleto con
+//    una rama suficientemente larga es una extremidad.
+// 4. Las extremidades se reparten por su posición respecto del torso: la más vertical por
+//    encima es la cabeza, las más bajas (en el tercio inferior) los pies y, de las demás,
+//    las dos más alejadas del torso las manos. Izquierda/derecha se decide por el lado del
+//    frame espejado, como con los marcadores.
+//
+// Todo el trabajo se hace en el nivel reducido, en un solo hilo, con buffers que se
+// reutilizan entre frames. Necesita una cámara fija: si la cámara se mueve, reset().
+class SilhouetteDetector : public PoseDetector {
+public:
+    const char* name() const override { return "silhouette"; }
+    void detect(const cv::Mat& frame, DetectedPose& pose) override;
+    // Vuelve a aprender el fondo (la escena debe quedar vacía durante learningFrames frames).
+    void reset() override;
+
+    bool isLearning() const { return learnedFrames < learningFrames; }
+    // Silueta limpia del último frame (255 = persona), en el nivel reducido. Para depuración.
+    const cv::Mat& silhouette() const { return silhouetteMask; }
+
+    int workScale = 4;
+    int learningFrames = 30;
+    float backgroundRate = 0.02f;         // Adaptación del fondo por frame
+    int foregroundThreshold = 40;         // Suma de |diferencias| B + G + R con el fondo
+    double minSilhouetteFraction = 0.02;  // Área mínima de la silueta (fracción del frame)
+    double minBranchFraction = 0.12;      // Rama mínima de una extremidad (fracción de la altura de la silueta)
+
+private:
+    struct Extremity {
+        cv::Point tip;
+        int length; // Pixels de la rama hasta la primera bifurcación
+        bool used;
+    };
+
+    void subtractBackground();
+    // Deja en silhouetteMask la componente más grande de foreground, sin huecos. Devuelve su
+    // número de pixels y su rectángulo.
+    int extractSilhouette(cv::Rect& bounds);
+    void thin();
+    void findExtremities();
+    int skeletonBranches(int x, int y) const;
+
+    cv::Mat small;           // Frame reducido (BGR)
+    cv::Mat background;      // Media del fondo (CV_32FC3)
+    cv::Mat foreground;      // Primer plano crudo y después limpio (CV_8UC1, 0 / 255)
+    cv::Mat silhouetteMask;  // Componente más grande sin huecos
+    cv::Mat distance;        // Transformada de distancia de la silueta
+    cv::Mat skeleton;        // 0 / 1, con un borde de un pixel siempre a 0
+    LabelMorphology morphology;
+    int learnedFrames = 0;
+
+    std::vector<int> component; // Índice de componente por pixel (-1 = sin visitar)
+    std::vector<int> stack;
+    std::vector<int> deletions;
+    std::vector<Extremity> extremities;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Instrumentación por etapa: temporizadores con alcance (PROFILE_STAGE) que alimentan
+// histogramas de tamaño fijo sin locks, de los que se obtienen p50/p95/p99.
+//
+// Se activa compilando con -DMOTION_PROFILING (make PROFILING=1, el valor por defecto).
+// Sin esa definición las macros no generan código y no hay ningún coste en tiempo de ejecución.
+
+enum class ProfileStage : std::uint8_t {
+    CameraRead,       // Lectura + espejado del frame de la cámara
+    Detection,        // Detección completa (marcadores de color o silueta)
+    ColorClassify,    // Tabla BGR -> etiqueta
+    Morphology,       // Erosión + dilatación
+    BlobExtraction,   // Componentes conexas y centroides
+    CentroidRefine,   // Refinamiento a resolución completa de la detección piramidal
+    PoseUpdate,       // StickFigure::updatePose
+    Draw,             // StickFigure::draw
+    Present,          // window.display()
+    CaptureToPresent, // Desde que se capturó el frame hasta que su pose se muestra en pantalla
+    Count
+};
+
+constexpr std::size_t kProfileStageCount = static_cast<std::size_t>(ProfileStage::Count);
+
+const char* profileStageName(ProfileStage stage);
+
+// Histograma de latencias en microsegundos con cubos logarítmicos (16 subdivisiones por
+// potencia de 2, error relativo < 6.25%). Hasta 2^25 us (~33 s); los valores mayores van al último cubo.
+// record() se puede llamar desde cualquier hilo: solo hace incrementos atómicos relajados.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kSubBuckets = 16;
+    static constexpr std::size_t kBucketCount = 352;
+
+    void record(std::uint64_t micros);
+    void reset();
+
+    std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    // Percentil (0..100) en microsegundos, con la resolución del cubo. 0 si no hay muestras.
+    double percentile(double p) const;
+    double maxMicros() const { return static_cast<double>(maximum.load(std::memory_order_relaxed)); }
+
+private:
+    static std::size_t bucketIndex(std::uint64_t micros);
+    static double bucketMidpoint(std::size_t index);
+
+    std::array<std::atomic<std::uint32_t>, kBucketCount> buckets{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> maximum{0};
+};
+
+class StageProfiler {
+public:
+    static StageProfiler& instance();
+
+    void record(ProfileStage stage, std::chrono::steady_clock::duration elapsed);
+    const LatencyHistogram& histogram(ProfileStage stage) const {
+        return histograms[static_cast<std::size_t>(stage)];
+    }
+    void reset();
+
+    // Una línea por etapa con muestras: "nombre  p50  p95  p99  max  n" (en ms).
+    std::vector<std::string> summaryLines() const;
+    // Volcado CSV: stage,count,p50_ms,p95_ms,p99_ms,max_ms
+    bool writeCsv(const std::string& path) const;
+
+private:
+    StageProfiler() = default;
+    std::array<LatencyHistogram, kProfileStageCount> histograms;
+};
+
+// Mide el tiempo desde la construcción hasta el final del alcance.
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(ProfileStage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~ScopedStageTimer() { StageProfiler::instance().record(stage, std::chrono::steady_clock::now() - start); }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    ProfileStage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef MOTION_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_STAGE(stage) ScopedStageTimer PROFILE_CONCAT(profileTimer_, __LINE__)(ProfileStage::stage)
+#define PROFILE_RECORD(stage, elapsed) StageProfiler::instance().record(ProfileStage::stage, (elapsed))
+#define PROFILING_ENABLED 1
+#else
+#define PROFILE_STAGE(stage) ((void)0)
+#define PROFILE_RECORD(stage, elapsed) ((void)0)
+#define PROFILING_ENABLED 0
+#endif
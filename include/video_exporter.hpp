@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Opciones del modo de exportación sin ventana (--export).
+struct ExportOptions {
+    std::string outputPath;     // Video de salida (.avi con MJPG)
+    std::string trackPath;      // Pista .ptrk a exportar (--play); vacía = animación de demostración
+    double demoSeconds = 10.0;  // Duración de la demo (la pista se exporta completa)
+    double fps = 30.0;          // Frames por segundo del video (la pista se remuestrea según sus timestamps)
+    unsigned width = 1024;
+    unsigned height = 768;
+    int buffers = 4;            // Buffers de frame entre el render y el codificador
+};
+
+// Exporta la figura animada a un archivo de video sin ventana: cada frame se dibuja en un
+// sf::RenderTexture, se lee (glReadPixels) en un buffer libre de AsyncVideoEncoder y el render sigue con
+// el siguiente mientras el hilo codificador escribe el anterior. No va atado al reloj: los
+// frames se generan tan rápido como se pueden dibujar y codificar.
+//
+// sf::RenderTexture necesita un contexto OpenGL; en un servidor sin pantalla basta con
+// un servidor X virtual (xvfb-run) o una compilación de SFML con EGL.
+class VideoExporter {
+public:
+    struct Stats {
+        std::uint64_t frames = 0;
+        double seconds = 0.0;         // Tiempo total, desde el primer frame hasta cerrar el archivo
+        double framesPerSecond = 0.0;
+        double realtimeFactor = 0.0;  // Segundos de video por segundo de exportación
+        double renderFps = 0.0;       // Solo dibujar y leer los pixels
+        double encodeFps = 0.0;       // Solo convertir y escribir (hilo codificador)
+        std::uint64_t producerWaits = 0;
+    };
+
+    explicit VideoExporter(const ExportOptions& options);
+
+    // Exporta el video completo e informa los frames por segundo. false si hubo un error.
+    bool run();
+
+    const Stats& stats() const { return result; }
+
+private:
+    ExportOptions options;
+    Stats result;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+
+// Devuelve una vista de `size` sobre `storage`, que solo crece (nunca se reduce). Así los
+// buffers de trabajo cuyo tamaño cambia en cada frame (p. ej. las ventanas de seguimiento)
+// no reservan memoria una vez que alcanzaron su tamaño máximo. La vista puede no ser
+// continua, así que debe recorrerse fila por fila con ptr(y).
+inline cv::Mat workBuffer(cv::Mat& storage, cv::Size size, int type) {
+    if (storage.type() != type || storage.rows < size.height || storage.cols < size.width) {
+        storage.create(std::max(storage.rows, size.height), std::max(storage.cols, size.width), type);
+    }
+    return storage(cv::Rect(0, 0, size.width, size.height));
+}
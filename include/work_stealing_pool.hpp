@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Grupo de hilos para tareas independientes, con una cola por hilo y robo de trabajo.
+//
+// Una tarea que se encola desde un hilo del grupo va a la cola de ese hilo (normalmente la
+// tarea que se reprograma a sí misma sigue en el mismo núcleo, con sus datos en caché);
+// desde fuera del grupo se reparten por turnos. Un hilo sin trabajo en su cola roba de la
+// cola de otro antes de dormirse. Las colas son FIFO para el dueño: con más fuentes que
+// hilos, las tareas que se reprograman se alternan en vez de acaparar un hilo.
+//
+// A diferencia de ParallelFor, submit() no espera: las tareas se ejecutan en segundo plano
+// y el destructor espera a que terminen las que ya estaban encoladas.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    struct Stats {
+        std::uint64_t executed = 0; // Tareas ejecutadas
+        std::uint64_t stolen = 0;   // De ellas, las que se tomaron de la cola de otro hilo
+    };
+
+    // 0 = número de núcleos.
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Se puede llamar desde cualquier hilo, también desde una tarea.
+    void submit(Task task);
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()); }
+    Stats stats() const;
+
+private:
+    // Cola circular con su propio mutex; la memoria solo crece, así que con una carga
+    // estable no se reserva memoria al encolar.
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Task> ring;
+        std::size_t head = 0;
+        std::size_t count = 0;
+
+        void push(Task&& task);
+        bool popFront(Task& task);
+        bool popBack(Task& task);
+    };
+
+    void workerLoop(std::size_t index);
+    bool takeTask(std::size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> pending{0}; // Tareas encoladas que nadie tomó todavía
+    bool stopping = false;
+
+    std::atomic<std::size_t> nextQueue{0};
+    std::atomic<std::uint64_t> executed{0};
+    std::atomic<std::uint64_t> stolen{0};
+};
@@ -0,0 +1,160 @@
+#include "animation_clip.hpp"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+bool parseJoint(const std::string& name, std::size_t& index) {
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        if (name == jointName(static_cast<JointID>(j))) {
+            index = j;
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+bool AnimationClip::loadFromFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "ERROR: No se pudo abrir el clip " << path << std::endl;
+        return false;
+    }
+
+    AnimationClip clip;
+    clip.mask.fill(1.f);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key) || key[0] == '#') {
+            continue;
+        }
+        bool ok = true;
+        if (key == "clip") {
+            ok = static_cast<bool>(fields >> clip.clipName);
+        } else if (key == "rate") {
+            ok = (fields >> clip.rate) && clip.rate > 0.f;
+        } else if (key == "loop") {
+            int loop = 1;
+            ok = static_cast<bool>(fields >> loop);
+            clip.looping = loop != 0;
+        } else if (key == "joints") {
+            std::string name;
+            clip.mask.fill(0.f);
+            while (ok && fields >> name) {
+                std::size_t index = 0;
+                if (name == "ALL") {
+                    clip.mask.fill(1.f);
+                } else if (parseJoint(name, index)) {
+                    clip.mask[index] = 1.f;
+                } else {
+                    ok = false;
+                }
+            }
+        } else if (key == "f") {
+            for (std::size_t j = 0; j < kJointCount && ok; ++j) {
+                float x = 0.f, y = 0.f;
+                ok = static_cast<bool>(fields >> x >> y);
+                clip.xs.push_back(x);
+                clip.ys.push_back(y);
+            }
+            ++clip.frames;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "ERROR: Línea " << lineNumber << " no válida en el clip " << path << std::endl;
+            return false;
+        }
+    }
+    if (clip.frames == 0) {
+        std::cerr << "ERROR: El clip " << path << " no tiene frames." << std::endl;
+        return false;
+    }
+    *this = std::move(clip);
+    return true;
+}
+
+bool AnimationClip::saveToFile(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "ERROR: No se pudo escribir el clip " << path << std::endl;
+        return false;
+    }
+    out << "# Clip de animación: posiciones relativas al centro de la figura, en pixels a escala 1.\n";
+    out << "# Cada línea 'f' tiene los pares x y de las articulaciones en el orden de JointID.\n";
+    out << "clip " << clipName << "\nrate " << rate << "\nloop " << (looping ? 1 : 0) << "\njoints";
+    bool all = true;
+    for (float m : mask) all = all && m > 0.f;
+    if (all) {
+        out << " ALL";
+    } else {
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            if (mask[j] > 0.f) out << ' ' << jointName(static_cast<JointID>(j));
+        }
+    }
+    out << '\n';
+    out.setf(std::ios::fixed);
+    out.precision(2);
+    for (std::size_t f = 0; f < frames; ++f) {
+        out << 'f';
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            out << ' ' << xs[f * kJointCount + j] << ' ' << ys[f * kJointCount + j];
+        }
+        out << '\n';
+    }
+    return true;
+}
+
+AnimationClip AnimationClip::bake(const std::string& name, float frameRate, std::size_t frameCount, bool loop,
+                                  const std::function<void(float, float*, float*)>& pose) {
+    AnimationClip clip;
+    clip.clipName = name;
+    clip.rate = frameRate;
+    clip.frames = frameCount;
+    clip.looping = loop;
+    clip.mask.fill(1.f);
+    clip.xs.resize(frameCount * kJointCount);
+    clip.ys.resize(frameCount * kJointCount);
+    for (std::size_t f = 0; f < frameCount; ++f) {
+        pose(static_cast<float>(f) / frameRate, &clip.xs[f * kJointCount], &clip.ys[f * kJointCount]);
+    }
+    return clip;
+}
+
+void AnimationClip::sample(float time, float* outX, float* outY) const {
+    if (frames == 0) {
+        return;
+    }
+    float position = time * rate;
+    std::size_t i0, i1;
+    float t;
+    if (looping) {
+        position = std::fmod(position, static_cast<float>(frames));
+        if (position < 0.f) position += static_cast<float>(frames);
+        i0 = static_cast<std::size_t>(position);
+        if (i0 >= frames) i0 = 0; // Redondeo justo en el final del ciclo
+        i1 = i0 + 1 < frames ? i0 + 1 : 0;
+        t = position - static_cast<float>(i0);
+    } else {
+        float last = static_cast<float>(frames - 1);
+        position = position < 0.f ? 0.f : (position > last ? last : position);
+        i0 = static_cast<std::size_t>(position);
+        i1 = i0 + 1 < frames ? i0 + 1 : i0;
+        t = position - static_cast<float>(i0);
+    }
+
+    const float* x0 = &xs[i0 * kJointCount];
+    const float* x1 = &xs[i1 * kJointCount];
+    const float* y0 = &ys[i0 * kJointCount];
+    const float* y1 = &ys[i1 * kJointCount];
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        outX[j] = x0[j] + (x1[j] - x0[j]) * t;
+        outY[j] = y0[j] + (y1[j] - y0[j]) * t;
+    }
+}
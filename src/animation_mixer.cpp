@@ -0,0 +1,154 @@
+#include "animation_mixer.hpp"
+#include <algorithm>
+#include <cmath>
+
+void AnimationMixer::clear() {
+    layers = {};
+}
+
+void AnimationMixer::setLayer(const AnimationClip* clip, float weight, float fadeSeconds) {
+    if (!clip) {
+        return;
+    }
+    Layer* layer = nullptr;
+    for (auto& candidate : layers) {
+        if (candidate.clip == clip) {
+            layer = &candidate;
+            break;
+        }
+    }
+    if (!layer) {
+        // Capa nueva: un hueco libre o, si no hay, la de menor peso.
+        layer = &*std::min_element(layers.begin(), layers.end(), [](const Layer& a, const Layer& b) {
+            if ((a.clip == nullptr) != (b.clip == nullptr)) return a.clip == nullptr;
+            return a.weight < b.weight;
+        });
+        *layer = Layer{};
+        layer->clip = clip;
+    }
+    layer->targetWeight = weight;
+    if (fadeSeconds > 0.f) {
+        layer->fadeRate = 1.f / fadeSeconds;
+    } else {
+        layer->fadeRate = 0.f;
+        layer->weight = weight;
+    }
+}
+
+void AnimationMixer::crossfadeTo(const AnimationClip* clip, float fadeSeconds) {
+    for (auto& layer : layers) {
+        if (layer.clip && layer.clip != clip) {
+            layer.targetWeight = 0.f;
+            layer.fadeRate = fadeSeconds > 0.f ? 1.f / fadeSeconds : 0.f;
+            if (fadeSeconds <= 0.f) layer.weight = 0.f;
+        }
+    }
+    setLayer(clip, 1.f, fadeSeconds);
+}
+
+void AnimationMixer::update(float dt) {
+    for (auto& layer : layers) {
+        if (!layer.clip) {
+            continue;
+        }
+        // El tiempo se mantiene dentro del clip: acumulado sin límite, un float pierde la
+        // precisión de un frame al cabo de unas horas y la animación va a saltos.
+        layer.time += dt;
+        const float duration = layer.clip->duration();
+        if (duration > 0.f) {
+            layer.time = layer.clip->loops() ? std::fmod(layer.time, duration) : std::min(layer.time, duration);
+        }
+        if (layer.fadeRate > 0.f) {
+            float step = layer.fadeRate * dt;
+            if (layer.weight < layer.targetWeight) {
+                layer.weight = std::min(layer.weight + step, layer.targetWeight);
+            } else {
+                layer.weight = std::max(layer.weight - step, layer.targetWeight);
+            }
+        }
+        if (layer.weight <= 0.f && layer.targetWeight <= 0.f) {
+            layer = Layer{}; // Terminó de desvanecerse
+        }
+    }
+}
+
+void AnimationMixer::evaluate(sf::Vector2f origin, float scale, DetectedPose& out) const {
+    alignas(16) float sumX[kJointCount] = {};
+    alignas(16) float sumY[kJointCount] = {};
+    alignas(16) float sumW[kJointCount] = {};
+    alignas(16) float xs[kJointCount];
+    alignas(16) float ys[kJointCount];
+
+    for (const auto& layer : layers) {
+        if (!layer.clip || layer.weight <= 0.f) {
+            continue;
+        }
+        layer.clip->sample(layer.time, xs, ys);
+        const auto& mask = layer.clip->jointMask();
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            float w = layer.weight * mask[j];
+            sumX[j] += xs[j] * w;
+            sumY[j] += ys[j] * w;
+            sumW[j] += w;
+        }
+    }
+
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        if (sumW[j] > 0.f) {
+            out.positions[j] = sf::Vector2f(origin.x + sumX[j] / sumW[j] * scale, origin.y + sumY[j] / sumW[j] * scale);
+            out.confidence[j] = std::min(sumW[j], 1.f);
+        } else {
+            out.confidence[j] = 0.f;
+        }
+    }
+}
+
+const AnimationClip* AnimationMixer::dominantClip() const {
+    const Layer* best = nullptr;
+    for (const auto& layer : layers) {
+        if (layer.clip && (!best || layer.weight > best->weight)) {
+            best = &layer;
+        }
+    }
+    return best ? best->clip : nullptr;
+}
+
+void overlayLivePose(const DetectedPose& live, DetectedPose& animated) {
+    // Centroides de las articulaciones presentes en las dos poses.
+    sf::Vector2f liveCenter, clipCenter;
+    int shared = 0;
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        if (live.confidence[j] > 0.f && animated.confidence[j] > 0.f) {
+            liveCenter += live.positions[j];
+            clipCenter += animated.positions[j];
+            ++shared;
+        }
+    }
+    if (shared == 0) {
+        return;
+    }
+    liveCenter /= static_cast<float>(shared);
+    clipCenter /= static_cast<float>(shared);
+
+    // Escala: cociente de las dispersiones alrededor de los centroides (siempre positiva,
+    // aunque las articulaciones del clip y las detectadas no estén en la misma postura).
+    float liveSpread = 0.f, clipSpread = 0.f;
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        if (live.confidence[j] > 0.f && animated.confidence[j] > 0.f) {
+            sf::Vector2f l = live.positions[j] - liveCenter;
+            sf::Vector2f c = animated.positions[j] - clipCenter;
+            liveSpread += l.x * l.x + l.y * l.y;
+            clipSpread += c.x * c.x + c.y * c.y;
+        }
+    }
+    const float scale = shared > 1 && clipSpread > 1e-3f && liveSpread > 1e-3f ? std::sqrt(liveSpread / clipSpread) : 1.f;
+
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        if (live.confidence[j] > 0.f) {
+            animated.positions[j] = live.positions[j];
+            animated.confidence[j] = live.confidence[j];
+        } else {
+            animated.positions[j] = liveCenter + (animated.positions[j] - clipCenter) * scale;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include "async_video_encoder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+AsyncVideoEncoder::~AsyncVideoEncoder() {
+    finish();
+}
+
+bool AsyncVideoEncoder::open(const std::string& path, cv::Size frameSize, double fps, int bufferCount, int fourcc) {
+    finish();
+    if (!writer.open(path, fourcc, fps, frameSize, true)) {
+        std::cerr << "ERROR: No se pudo crear el video " << path << " (¿OpenCV sin el codificador pedido?)" << std::endl;
+        return false;
+    }
+    buffers.resize(static_cast<std::size_t>(std::max(2, bufferCount)));
+    for (cv::Mat& buffer : buffers) {
+        buffer.create(frameSize, CV_8UC4);
+    }
+    submitted = 0;
+    written = 0;
+    closing = false;
+    waits = 0;
+    encodeSeconds = 0.0;
+    worker = std::thread(&AsyncVideoEncoder::encodeLoop, this);
+    return true;
+}
+
+cv::Mat& AsyncVideoEncoder::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (submitted - written >= buffers.size()) {
+        ++waits;
+        changed.wait(lock, [this] { return submitted - written < buffers.size(); });
+    }
+    return buffers[submitted % buffers.size()];
+}
+
+void AsyncVideoEncoder::submit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++submitted;
+    }
+    changed.notify_all();
+}
+
+void AsyncVideoEncoder::finish() {
+    if (!worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    changed.notify_all();
+    worker.join();
+    writer.release();
+}
+
+AsyncVideoEncoder::Stats AsyncVideoEncoder::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s;
+    s.framesWritten = written;
+    s.producerWaits = waits;
+    s.encodeSeconds = encodeSeconds;
+    return s;
+}
+
+void AsyncVideoEncoder::encodeLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return written < submitted || closing; });
+        if (written == submitted) {
+            break; // Cerrando y sin frames pendientes
+        }
+        // El productor no toca este buffer hasta que `written` avance.
+        const cv::Mat& frame = buffers[written % buffers.size()];
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        cv::cvtColor(frame, converted, cv::COLOR_RGBA2BGR);
+        writer.write(converted);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        lock.lock();
+        encodeSeconds += seconds;
+        ++written;
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,188 @@
+#include "bit_mask.hpp"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIT_MASK_SSE2 1
+#endif
+
+void BitMask::resize(int rows, int cols) {
+    rowCount = rows;
+    colCount = cols;
+    rowWords = (cols + 63) / 64;
+    tailMask = (cols % 64) ? (std::uint64_t{1} << (cols % 64)) - 1 : ~std::uint64_t{0};
+    const std::size_t needed = static_cast<std::size_t>(rows) * static_cast<std::size_t>(rowWords);
+    if (words.size() < needed) {
+        words.resize(needed);
+    }
+}
+
+void BitMask::fromLabels(const cv::Mat& labels) {
+    CV_Assert(labels.type() == CV_8UC1);
+    resize(labels.rows, labels.cols);
+    for (int y = 0; y < rowCount; ++y) {
+        const std::uint8_t* src = labels.ptr<std::uint8_t>(y);
+        std::uint64_t* dst = row(y);
+        for (int w = 0; w < rowWords; ++w) {
+            const int x0 = w * 64;
+            const int n = std::min(64, colCount - x0);
+            std::uint64_t bits = 0;
+#ifdef BIT_MASK_SSE2
+            if (n == 64) {
+                // 16 bytes por comparación: movemask da 1 bit por byte igual a 0.
+                const __m128i zero = _mm_setzero_si128();
+                for (int k = 0; k < 4; ++k) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x0 + 16 * k));
+                    std::uint64_t isZero = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)));
+                    bits |= (~isZero & 0xFFFFu) << (16 * k);
+                }
+                dst[w] = bits;
+                continue;
+            }
+#endif
+            for (int i = 0; i < n; ++i) {
+                bits |= static_cast<std::uint64_t>(src[x0 + i] != 0) << i;
+            }
+            dst[w] = bits;
+        }
+    }
+}
+
+void BitMask::toMat(cv::Mat& mask) const {
+    mask.create(rowCount, colCount, CV_8UC1);
+    for (int y = 0; y < rowCount; ++y) {
+        std::uint8_t* dst = mask.ptr<std::uint8_t>(y);
+        for (int x = 0; x < colCount; ++x) {
+            dst[x] = test(x, y) ? 255 : 0;
+        }
+    }
+}
+
+namespace {
+// `count` bits (1..64) de una fila a partir del bit `position`.
+inline std::uint64_t readBits(const std::uint64_t* row, int position, int count) {
+    const int word = position >> 6;
+    const int shift = position & 63;
+    std::uint64_t bits = row[word] >> shift;
+    if (shift != 0 && shift + count > 64) {
+        bits |= row[word + 1] << (64 - shift);
+    }
+    return count == 64 ? bits : bits & ((std::uint64_t{1} << count) - 1);
+}
+
+// Sustituye `count` bits (1..64) de una fila a partir del bit `position`.
+inline void writeBits(std::uint64_t* row, int position, int count, std::uint64_t bits) {
+    const std::uint64_t mask = count == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << count) - 1;
+    const int word = position >> 6;
+    const int shift = position & 63;
+    row[word] = (row[word] & ~(mask << shift)) | (bits << shift);
+    if (shift != 0 && shift + count > 64) {
+        row[word + 1] = (row[word + 1] & ~(mask >> (64 - shift))) | (bits >> (64 - shift));
+    }
+}
+}
+
+void BitMask::copyRegion(const BitMask& source, const cv::Rect& from, cv::Point to) {
+    for (int y = 0; y < from.height; ++y) {
+        const std::uint64_t* src = source.row(from.y + y);
+        std::uint64_t* dst = row(to.y + y);
+        for (int x = 0; x < from.width; x += 64) {
+            const int count = std::min(64, from.width - x);
+            writeBits(dst, to.x + x, count, readBits(src, from.x + x, count));
+        }
+        if (to.x + from.width == colCount) {
+            dst[rowWords - 1] &= tailMask; // La fila llega al final: el relleno vuelve a 0
+        }
+    }
+}
+
+namespace {
+// Vecino a distancia d a la izquierda (bit x <- bit x - d) y a la derecha (bit x <- bit x + d)
+// de la palabra i de una fila; `fill` es el valor de los pixels fuera de la fila.
+inline std::uint64_t leftNeighbors(const std::uint64_t* row, int i, int d, std::uint64_t fill) {
+    std::uint64_t previous = i > 0 ? row[i - 1] : fill;
+    return (row[i] << d) | (previous >> (64 - d));
+}
+
+inline std::uint64_t rightNeighbors(const std::uint64_t* row, int i, int words, int d, std::uint64_t fill) {
+    std::uint64_t next = i + 1 < words ? row[i + 1] : fill;
+    return (row[i] >> d) | (next << (64 - d));
+}
+}
+
+template <bool Erode>
+void BitMorphology::apply(BitMask& mask, int kernelSize) {
+    CV_Assert(kernelSize == 3 || kernelSize == 5);
+    const int rows = mask.rows();
+    const int words = mask.wordsPerRow();
+    const int radius = kernelSize / 2;  // Rectángulo alto: 1 x kernelSize
+    const int wideRadius = radius - 1;  // Rectángulo ancho: kernelSize x (kernelSize - 2)
+    const std::uint64_t tail = mask.lastWordMask();
+    // En la erosión, lo que queda fuera de la imagen (incluido el relleno) cuenta como 1.
+    const std::uint64_t fill = Erode ? ~std::uint64_t{0} : 0;
+    auto combine = [](std::uint64_t a, std::uint64_t b) { return Erode ? (a & b) : (a | b); };
+
+    source.resize(rows, mask.cols());
+    horizontal.resize(rows, mask.cols());
+    for (int y = 0; y < rows; ++y) {
+        std::copy_n(mask.row(y), words, source.row(y));
+        if (Erode && words > 0) {
+            source.row(y)[words - 1] |= ~tail;
+        }
+    }
+
+    // Pasada horizontal del rectángulo ancho: 64 pixels por operación.
+    for (int y = 0; y < rows; ++y) {
+        const std::uint64_t* s = source.row(y);
+        std::uint64_t* h = horizontal.row(y);
+        for (int i = 0; i < words; ++i) {
+            std::uint64_t v = s[i];
+            for (int d = 1; d <= radius; ++d) {
+                v = combine(v, leftNeighbors(s, i, d, fill));
+                v = combine(v, rightNeighbors(s, i, words, d, fill));
+            }
+            h[i] = v;
+        }
+    }
+
+    // Pasada vertical de ambos rectángulos, palabra a palabra, escribiendo sobre la entrada.
+    for (int y = 0; y < rows; ++y) {
+        std::uint64_t* out = mask.row(y);
+        std::copy_n(horizontal.row(y), words, out);
+        for (int d = 1; d <= wideRadius; ++d) {
+            if (y - d >= 0) {
+                const std::uint64_t* r = horizontal.row(y - d);
+                for (int i = 0; i < words; ++i) out[i] = combine(out[i], r[i]);
+            }
+            if (y + d < rows) {
+                const std::uint64_t* r = horizontal.row(y + d);
+                for (int i = 0; i < words; ++i) out[i] = combine(out[i], r[i]);
+            }
+        }
+        for (int d = 1; d <= radius; ++d) {
+            if (y - d >= 0) {
+                const std::uint64_t* r = source.row(y - d);
+                for (int i = 0; i < words; ++i) out[i] = combine(out[i], r[i]);
+            }
+            if (y + d < rows) {
+                const std::uint64_t* r = source.row(y + d);
+                for (int i = 0; i < words; ++i) out[i] = combine(out[i], r[i]);
+            }
+        }
+        if (words > 0) {
+            out[words - 1] &= tail; // El relleno vuelve a 0
+        }
+    }
+}
+
+void BitMorphology::erode(BitMask& mask, int kernelSize, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        apply<true>(mask, kernelSize);
+    }
+}
+
+void BitMorphology::dilate(BitMask& mask, int kernelSize, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        apply<false>(mask, kernelSize);
+    }
+}
@@ -0,0 +1,204 @@
+#include "blob_extractor.hpp"
+#include <algorithm>
+
+std::uint32_t BlobExtractor::findRoot(std::uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]]; // Compresión de camino por mitades
+        i = parent[i];
+    }
+    return i;
+}
+
+void BlobExtractor::unite(std::uint32_t a, std::uint32_t b) {
+    a = findRoot(a);
+    b = findRoot(b);
+    // La raíz es siempre el run más antiguo, así el orden de salida sigue el orden raster.
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+void BlobExtractor::addRun(int y, int x0, int x1, std::uint32_t border, std::size_t& j, std::size_t prevEnd) {
+    const auto index = static_cast<std::uint32_t>(runs.size());
+    runs.push_back({y, x0, x1, border});
+    parent.push_back(index);
+
+    // Unir con los runs de la fila anterior que se tocan en 8-conectividad.
+    while (j < prevEnd && runs[j].x1 < x0 - 1) ++j;
+    for (std::size_t k = j; k < prevEnd && runs[k].x0 <= x1 + 1; ++k) {
+        unite(static_cast<std::uint32_t>(k), index);
+    }
+}
+
+void BlobExtractor::extract(const cv::Mat& mask, cv::Point offset, int labelCount) {
+    CV_Assert(mask.type() == CV_8UC1);
+    runs.clear();
+    parent.clear();
+
+    const int rows = mask.rows;
+    const int cols = mask.cols;
+    std::size_t prevBegin = 0, prevEnd = 0;
+
+    for (int y = 0; y < rows; ++y) {
+        const std::uint8_t* row = mask.ptr<std::uint8_t>(y);
+        const std::uint8_t* up = y > 0 ? mask.ptr<std::uint8_t>(y - 1) : nullptr;
+        const std::uint8_t* down = y + 1 < rows ? mask.ptr<std::uint8_t>(y + 1) : nullptr;
+        const std::size_t rowBegin = runs.size();
+        std::size_t j = prevBegin;
+
+        int x = 0;
+        while (x < cols) {
+            while (x < cols && row[x] == 0) ++x;
+            if (x == cols) break;
+            const int x0 = x;
+            while (x < cols && row[x] != 0) ++x;
+            const int x1 = x - 1;
+
+            // Los extremos del run siempre son borde; en el interior, los que no tienen
+            // vecino arriba o abajo (fuera de la imagen cuenta como vacío).
+            std::uint32_t border = x1 > x0 ? 2u : 1u;
+            for (int i = x0 + 1; i < x1; ++i) {
+                border += (!up || up[i] == 0 || !down || down[i] == 0) ? 1u : 0u;
+            }
+            addRun(y, x0, x1, border, j, prevEnd);
+        }
+
+        prevBegin = rowBegin;
+        prevEnd = runs.size();
+    }
+
+    accumulateBlobs(offset);
+    voteLabels(mask, labelCount);
+}
+
+namespace {
+// Primer pixel >= from con bit a `value` (o `cols` si no hay ninguno). Los bits de relleno son 0.
+template <bool Value>
+int findBit(const std::uint64_t* row, int words, int from, int cols) {
+    if (from >= cols) return cols;
+    int i = from >> 6;
+    std::uint64_t word = (Value ? row[i] : ~row[i]) & (~std::uint64_t{0} << (from & 63));
+    while (word == 0) {
+        if (++i >= words) return cols;
+        word = Value ? row[i] : ~row[i];
+    }
+    return std::min(cols, i * 64 + __builtin_ctzll(word));
+}
+
+// Cantidad de pixels en [from, to] con bit a 1 en las dos filas.
+std::uint32_t countBoth(const std::uint64_t* a, const std::uint64_t* b, int from, int to) {
+    std::uint32_t count = 0;
+    const int firstWord = from >> 6;
+    const int lastWord = to >> 6;
+    for (int i = firstWord; i <= lastWord; ++i) {
+        std::uint64_t word = a[i] & b[i];
+        if (i == firstWord) word &= ~std::uint64_t{0} << (from & 63);
+        if (i == lastWord && (to & 63) != 63) word &= (std::uint64_t{1} << ((to & 63) + 1)) - 1;
+        count += static_cast<std::uint32_t>(__builtin_popcountll(word));
+    }
+    return count;
+}
+}
+
+void BlobExtractor::extract(const BitMask& mask, cv::Point offset, const cv::Mat& labels, int labelCount) {
+    CV_Assert(labelCount <= 0 || (labels.type() == CV_8UC1 && labels.rows == mask.rows() && labels.cols == mask.cols()));
+    runs.clear();
+    parent.clear();
+
+    const int rows = mask.rows();
+    const int cols = mask.cols();
+    const int words = mask.wordsPerRow();
+    std::size_t prevBegin = 0, prevEnd = 0;
+
+    for (int y = 0; y < rows; ++y) {
+        const std::uint64_t* row = mask.row(y);
+        const std::uint64_t* up = y > 0 ? mask.row(y - 1) : nullptr;
+        const std::uint64_t* down = y + 1 < rows ? mask.row(y + 1) : nullptr;
+        const std::size_t rowBegin = runs.size();
+        std::size_t j = prevBegin;
+
+        int x = findBit<true>(row, words, 0, cols);
+        while (x < cols) {
+            const int x0 = x;
+            const int x1 = findBit<false>(row, words, x0, cols) - 1;
+
+            // Mismo criterio de borde que la versión de bytes, contando de 64 en 64 los
+            // pixels interiores que sí tienen vecino arriba y abajo.
+            std::uint32_t border = x1 > x0 ? 2u : 1u;
+            if (x1 - x0 > 1) {
+                const std::uint32_t interior = static_cast<std::uint32_t>(x1 - x0 - 1);
+                border += (up && down) ? interior - countBoth(up, down, x0 + 1, x1 - 1) : interior;
+            }
+            addRun(y, x0, x1, border, j, prevEnd);
+            x = findBit<true>(row, words, x1 + 1, cols);
+        }
+
+        prevBegin = rowBegin;
+        prevEnd = runs.size();
+    }
+
+    accumulateBlobs(offset);
+    voteLabels(labels, labelCount);
+}
+
+void BlobExtractor::accumulateBlobs(cv::Point offset) {
+    results.clear();
+
+    // Acumular estadísticas por componente, en el orden de su primer run.
+    rootToBlob.assign(runs.size(), -1);
+    for (std::uint32_t i = 0; i < runs.size(); ++i) {
+        const Run& run = runs[i];
+        const std::uint32_t root = findRoot(i);
+        if (rootToBlob[root] < 0) {
+            rootToBlob[root] = static_cast<std::int32_t>(results.size());
+            Blob blob;
+            blob.minX = run.x0 + offset.x;
+            blob.maxX = run.x1 + offset.x;
+            blob.minY = blob.maxY = run.y + offset.y;
+            results.push_back(blob);
+        }
+        Blob& blob = results[rootToBlob[root]];
+        const int length = run.x1 - run.x0 + 1;
+        const int gx0 = run.x0 + offset.x;
+        const int gx1 = run.x1 + offset.x;
+        const int gy = run.y + offset.y;
+        blob.pixelCount += static_cast<std::uint32_t>(length);
+        blob.borderPixels += run.borderPixels;
+        blob.sumX += 0.5 * (static_cast<double>(gx0) + gx1) * length;
+        blob.sumY += static_cast<double>(gy) * length;
+        if (gx0 < blob.minX) blob.minX = gx0;
+        if (gx1 > blob.maxX) blob.maxX = gx1;
+        if (gy > blob.maxY) blob.maxY = gy;
+    }
+}
+
+void BlobExtractor::voteLabels(const cv::Mat& labels, int labelCount) {
+    if (labelCount <= 0) {
+        return;
+    }
+
+    // Votación de etiquetas: una segunda pasada solo sobre los pixels de los runs.
+    labelVotes.assign(results.size() * static_cast<std::size_t>(labelCount), 0);
+    for (std::uint32_t i = 0; i < runs.size(); ++i) {
+        const Run& run = runs[i];
+        std::uint32_t* votes = &labelVotes[static_cast<std::size_t>(rootToBlob[findRoot(i)]) * labelCount];
+        const std::uint8_t* row = labels.ptr<std::uint8_t>(run.y);
+        for (int x = run.x0; x <= run.x1; ++x) {
+            if (row[x] != 0 && row[x] <= labelCount) {
+                ++votes[row[x] - 1];
+            }
+        }
+    }
+    for (std::size_t b = 0; b < results.size(); ++b) {
+        const std::uint32_t* votes = &labelVotes[b * labelCount];
+        for (int l = 0; l < labelCount; ++l) {
+            results[b].votedPixels += votes[l];
+            if (votes[l] > results[b].labelPixels) {
+                results[b].labelPixels = votes[l];
+                results[b].label = static_cast<std::uint8_t>(l + 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include "capture_pipeline.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+// Tiempo de espera del hilo de detección cuando todavía no hay un frame nuevo.
+constexpr auto kIdleWait = std::chrono::microseconds(500);
+}
+
+CapturePipeline::CapturePipeline(MotionCapture& tracker) : tracker(tracker) {}
+
+CapturePipeline::~CapturePipeline() {
+    stop();
+}
+
+bool CapturePipeline::start(int cameraIndex) {
+    if (isRunning()) {
+        return true;
+    }
+    if (!tracker.isCameraOpen() && !tracker.initializeCamera(cameraIndex)) {
+        return false;
+    }
+
+    running.store(true, std::memory_order_relaxed);
+    captureThread = std::thread(&CapturePipeline::captureLoop, this);
+    detectionThread = std::thread(&CapturePipeline::detectionLoop, this);
+    std::cout << "Pipeline de captura iniciado." << std::endl;
+    return true;
+}
+
+void CapturePipeline::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    // El hilo de captura puede estar bloqueado hasta un período de cámara en read().
+    if (captureThread.joinable()) captureThread.join();
+    if (detectionThread.joinable()) detectionThread.join();
+    tracker.releaseCamera();
+
+    Stats s = stats();
+    std::cout << "Pipeline detenido. Frames capturados: " << s.framesCaptured
+              << ", descartados: " << s.framesDropped
+              << ", poses detectadas: " << s.posesDetected
+              << ", descartadas: " << s.posesDropped
+              << ", omitidos por intervalo: " << s.framesSkipped << std::endl;
+    DetectionGovernor::Stats g = governorStats();
+    if (g.framesMeasured > 0) {
+        std::cout << "Gobernador: detecciones medidas: " << g.framesMeasured
+                  << ", sobre el presupuesto: " << g.framesOverBudget
+                  << ", bajadas: " << g.downgrades
+                  << ", subidas: " << g.upgrades
+                  << ", nivel final: " << detectionGovernor.ladder()[static_cast<std::size_t>(g.level)].name << std::endl;
+    }
+}
+
+void CapturePipeline::captureLoop() {
+    std::uint64_t nextFrameId = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        FramePacket& packet = frameSlot.writeBuffer();
+        if (!tracker.readFrame(packet.image)) {
+            std::this_thread::sleep_for(kIdleWait);
+            continue;
+        }
+        packet.frameId = nextFrameId++;
+        packet.captureTime = PipelineClock::now();
+        frameSlot.publish();
+    }
+}
+
+void CapturePipeline::detectionLoop() {
+    int framesSinceDetection = 0;
+    // El gobernador solo toca el detector desde este hilo. Al activarse se guardan los
+    // ajustes del detector para restaurarlos al desactivarlo o al parar.
+    bool governing = false;
+    DetectionQuality userSettings{"user", 1, 1, 2, true, 30, 1};
+    auto restoreSettings = [&] {
+        tracker.pyramidScale = userSettings.pyramidScale;
+        tracker.erodeIterations = userSettings.erodeIterations;
+        tracker.dilateIterations = userSettings.dilateIterations;
+        tracker.roiTrackingEnabled = userSettings.roiTracking;
+        tracker.fullScanInterval = userSettings.fullScanInterval;
+    };
+    PoseDetector* detector = &tracker;
+    while (running.load(std::memory_order_relaxed)) {
+        PoseDetector* requested = activeDetector.load(std::memory_order_acquire);
+        if (!requested) {
+            requested = &tracker;
+        }
+        if (requested != detector) {
+            detector = requested;
+            detector->reset();
+        }
+        const bool colorMarkers = detector == &tracker;
+        if (governing != governorEnabled.load(std::memory_order_relaxed)) {
+            governing = !governing;
+            if (governing) {
+                userSettings = {"user", tracker.pyramidScale, tracker.erodeIterations, tracker.dilateIterations,
+                                tracker.roiTrackingEnabled, tracker.fullScanInterval, 1};
+                // Se empieza en el primer escalón que no es más caro que los ajustes actuales
+                // (p. ej. con --pyramid 2, en pyramid_x2).
+                const std::vector<DetectionQuality>& ladder = detectionGovernor.ladder();
+                int start = 0;
+                while (start + 1 < static_cast<int>(ladder.size()) &&
+                       ladder[static_cast<std::size_t>(start)].pyramidScale < tracker.pyramidScale) {
+                    ++start;
+                }
+                detectionGovernor.reset(start);
+                detectionGovernor.apply(tracker);
+            } else {
+                restoreSettings();
+            }
+        }
+        if (!frameSlot.consume()) {
+            std::this_thread::sleep_for(kIdleWait);
+            continue;
+        }
+        int interval = detectionInterval.load(std::memory_order_relaxed);
+        if (governing && colorMarkers) {
+            interval = std::max(interval, detectionGovernor.quality().detectionInterval);
+        }
+        if (++framesSinceDetection < interval) {
+            framesSkipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        framesSinceDetection = 0;
+        const FramePacket& frame = frameSlot.readBuffer();
+        PosePacket& pose = poseSlot.writeBuffer();
+        const PipelineClock::time_point detectStart = PipelineClock::now();
+        detector->detect(frame.image, pose.pose);
+        if (governing && colorMarkers && detectionGovernor.record(PipelineClock::now() - detectStart, interval)) {
+            detectionGovernor.apply(tracker);
+            DetectionGovernor::Stats g = detectionGovernor.stats();
+            std::cout << "Gobernador: nivel " << g.level << " (" << detectionGovernor.quality().name
+                      << "), coste medio " << g.averageMs << " ms por frame" << std::endl;
+        }
+        pose.frameId = frame.frameId;
+        pose.captureTime = frame.captureTime;
+        pose.detectTime = PipelineClock::now();
+        if (poseCallback) {
+            poseCallback(pose);
+        }
+        poseSlot.publish();
+    }
+    if (governing) {
+        restoreSettings();
+    }
+}
+
+const PosePacket* CapturePipeline::latestPose() {
+    if (!poseSlot.consume()) {
+        return nullptr;
+    }
+    return &poseSlot.readBuffer();
+}
+
+CapturePipeline::Stats CapturePipeline::stats() const {
+    Stats s;
+    s.framesCaptured = frameSlot.publishedCount();
+    s.framesDropped = frameSlot.droppedCount();
+    s.posesDetected = poseSlot.publishedCount();
+    s.posesDropped = poseSlot.droppedCount();
+    s.framesSkipped = framesSkipped.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,99 @@
+#include "change_gate.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHANGE_GATE_SSE2 1
+#endif
+
+cv::Rect ChangeGate::tileRect(int tx, int ty) const {
+    cv::Rect rect(tx * tileSize, ty * tileSize, tileSize, tileSize);
+    return rect & cv::Rect(0, 0, frameSize.width, frameSize.height);
+}
+
+bool ChangeGate::tileChanged(const cv::Mat& frame, const cv::Rect& rect) const {
+    const int bytes = rect.width * static_cast<int>(frame.elemSize());
+    const int x0 = rect.x * static_cast<int>(frame.elemSize());
+#ifdef CHANGE_GATE_SSE2
+    const __m128i limit = _mm_set1_epi32(threshold);
+#endif
+    for (int y = rect.y; y < rect.y + rect.height; ++y) {
+        const std::uint8_t* a = frame.ptr<std::uint8_t>(y) + x0;
+        const std::uint8_t* b = reference.ptr<std::uint8_t>(y) + x0;
+        int i = 0;
+#ifdef CHANGE_GATE_SSE2
+        // psadbw deja la suma de cada mitad de 8 bytes en los 16 bits bajos de cada mitad de 64.
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i sad = _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            if (_mm_movemask_epi8(_mm_cmpgt_epi32(sad, limit)) != 0) {
+                return true;
+            }
+        }
+#endif
+        for (; i < bytes; i += 8) {
+            const int end = std::min(bytes, i + 8);
+            int sum = 0;
+            for (int k = i; k < end; ++k) {
+                sum += std::abs(static_cast<int>(a[k]) - static_cast<int>(b[k]));
+            }
+            if (sum > threshold) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ChangeGate::detect(const cv::Mat& frame) {
+    frameSize = frame.size();
+    cols = (frame.cols + tileSize - 1) / tileSize;
+    rows = (frame.rows + tileSize - 1) / tileSize;
+    flags.assign(static_cast<std::size_t>(cols) * rows, 0);
+    if (!hasReference || reference.size() != frame.size() || reference.type() != frame.type()) {
+        std::fill(flags.begin(), flags.end(), 1);
+        dirty = cols * rows;
+        return;
+    }
+    dirty = 0;
+    for (int ty = 0; ty < rows; ++ty) {
+        for (int tx = 0; tx < cols; ++tx) {
+            if (tileChanged(frame, tileRect(tx, ty))) {
+                flags[static_cast<std::size_t>(ty) * cols + tx] = 1;
+                ++dirty;
+            }
+        }
+    }
+}
+
+void ChangeGate::markDirty(const cv::Rect& rect) {
+    cv::Rect clipped = rect & cv::Rect(0, 0, frameSize.width, frameSize.height);
+    if (clipped.empty()) {
+        return;
+    }
+    for (int ty = clipped.y / tileSize; ty <= (clipped.y + clipped.height - 1) / tileSize; ++ty) {
+        for (int tx = clipped.x / tileSize; tx <= (clipped.x + clipped.width - 1) / tileSize; ++tx) {
+            std::uint8_t& flag = flags[static_cast<std::size_t>(ty) * cols + tx];
+            dirty += flag == 0;
+            flag = 1;
+        }
+    }
+}
+
+void ChangeGate::commit(const cv::Mat& frame) {
+    if (!hasReference || reference.size() != frame.size() || reference.type() != frame.type()) {
+        frame.copyTo(reference);
+        hasReference = true;
+        return;
+    }
+    for (int ty = 0; ty < rows; ++ty) {
+        for (int tx = 0; tx < cols; ++tx) {
+            if (isDirty(tx, ty)) {
+                const cv::Rect rect = tileRect(tx, ty);
+                cv::Mat tile = reference(rect);
+                frame(rect).copyTo(tile);
+            }
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#include "color_lut.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COLOR_LUT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int kShift = 8 - ColorLut::kBitsPerChannel;
+
+inline std::uint32_t lutIndex(std::uint8_t b, std::uint8_t g, std::uint8_t r) {
+    return (std::uint32_t(b) >> kShift) |
+           ((std::uint32_t(g) >> kShift) << ColorLut::kBitsPerChannel) |
+           ((std::uint32_t(r) >> kShift) << (2 * ColorLut::kBitsPerChannel));
+}
+
+void classifyRowScalar(const std::uint8_t* src, std::uint8_t* dst, int x, int width, const std::uint8_t* table) {
+    for (; x < width; ++x) {
+        const std::uint8_t* px = src + 3 * x;
+        dst[x] = table[lutIndex(px[0], px[1], px[2])];
+    }
+}
+
+#ifdef COLOR_LUT_X86
+
+// A partir de dwords con B en el byte 0, G en el 1 y R en el 2, calcula el índice en la tabla.
+// Está escrito para kBitsPerChannel == 5.
+static_assert(ColorLut::kBitsPerChannel == 5, "Los kernels SIMD asumen 5 bits por canal");
+
+__attribute__((target("sse4.1")))
+inline __m128i lutIndexSse(__m128i bgr) {
+    __m128i b = _mm_srli_epi32(_mm_and_si128(bgr, _mm_set1_epi32(0x0000F8)), 3);
+    __m128i g = _mm_srli_epi32(_mm_and_si128(bgr, _mm_set1_epi32(0x00F800)), 6);
+    __m128i r = _mm_srli_epi32(_mm_and_si128(bgr, _mm_set1_epi32(0xF80000)), 9);
+    return _mm_or_si128(_mm_or_si128(b, g), r);
+}
+
+// 4 pixels por iteración: desentrelazado con pshufb y 4 lecturas escalares en la tabla.
+__attribute__((target("sse4.1")))
+int classifyRowSse41(const std::uint8_t* src, std::uint8_t* dst, int width, const std::uint8_t* table) {
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    int x = 0;
+    // Cada carga lee 16 bytes aunque solo usa 12: hay que dejar margen al final de la fila.
+    for (; x + 6 <= width; x += 4) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * x));
+        __m128i idx = lutIndexSse(_mm_shuffle_epi8(raw, spread));
+        dst[x + 0] = table[_mm_extract_epi32(idx, 0)];
+        dst[x + 1] = table[_mm_extract_epi32(idx, 1)];
+        dst[x + 2] = table[_mm_extract_epi32(idx, 2)];
+        dst[x + 3] = table[_mm_extract_epi32(idx, 3)];
+    }
+    return x;
+}
+
+// 8 pixels por iteración: desentrelazado con vpshufb por carril y lectura con vpgatherdd.
+__attribute__((target("avx2")))
+int classifyRowAvx2(const std::uint8_t* src, std::uint8_t* dst, int width, const std::uint8_t* table) {
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i low8 = _mm256_set1_epi32(0xFF);
+    const __m256i gatherBytes = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i joinLanes = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+    const __m256i maskB = _mm256_set1_epi32(0x0000F8);
+    const __m256i maskG = _mm256_set1_epi32(0x00F800);
+    const __m256i maskR = _mm256_set1_epi32(0xF80000);
+    const int* table32 = reinterpret_cast<const int*>(table);
+
+    int x = 0;
+    // La segunda carga empieza en el pixel 4 y lee 16 bytes: 28 bytes por cada 24 útiles.
+    for (; x + 10 <= width; x += 8) {
+        const std::uint8_t* px = src + 3 * x;
+        __m256i raw = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + 12)), 1);
+        __m256i bgr = _mm256_shuffle_epi8(raw, spread);
+        __m256i idx = _mm256_or_si256(
+            _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(bgr, maskB), 3),
+                            _mm256_srli_epi32(_mm256_and_si256(bgr, maskG), 6)),
+            _mm256_srli_epi32(_mm256_and_si256(bgr, maskR), 9));
+        __m256i values = _mm256_and_si256(_mm256_i32gather_epi32(table32, idx, 1), low8);
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, gatherBytes), joinLanes);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm256_castsi256_si128(packed));
+    }
+    return x;
+}
+
+enum class KernelLevel { Scalar, Sse41, Avx2 };
+
+KernelLevel detectKernelLevel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return KernelLevel::Avx2;
+    if (__builtin_cpu_supports("sse4.1")) return KernelLevel::Sse41;
+    return KernelLevel::Scalar;
+}
+
+const KernelLevel kKernelLevel = detectKernelLevel();
+
+#endif // COLOR_LUT_X86
+
+void classifyRow(const std::uint8_t* src, std::uint8_t* dst, int width, const std::uint8_t* table) {
+    int x = 0;
+#ifdef COLOR_LUT_X86
+    if (kKernelLevel == KernelLevel::Avx2) {
+        x = classifyRowAvx2(src, dst, width, table);
+    } else if (kKernelLevel == KernelLevel::Sse41) {
+        x = classifyRowSse41(src, dst, width, table);
+    }
+#endif
+    classifyRowScalar(src, dst, x, width, table);
+}
+
+} // namespace
+
+ColorLut::ColorLut() : table(kTableSize + 3, 0) {}
+
+bool ColorLut::update(const std::vector<HsvRange>& ranges) {
+    CV_Assert(ranges.size() <= kMaxRanges);
+    if (built && ranges == currentRanges) {
+        return false;
+    }
+    currentRanges = ranges;
+    rebuild();
+    return true;
+}
+
+void ColorLut::rebuild() {
+    // Se convierte el centro de cada celda con la misma cvtColor que usaba el código original,
+    // así la tabla hereda la semántica de cvtColor + inRange.
+    cv::Mat centers(1, static_cast<int>(kTableSize), CV_8UC3);
+    std::uint8_t* px = centers.ptr<std::uint8_t>(0);
+    const int half = 1 << (kShift - 1);
+    for (std::size_t i = 0; i < kTableSize; ++i) {
+        px[3 * i + 0] = static_cast<std::uint8_t>(((i >> 0) & (kLevels - 1)) << kShift | half);
+        px[3 * i + 1] = static_cast<std::uint8_t>(((i >> kBitsPerChannel) & (kLevels - 1)) << kShift | half);
+        px[3 * i + 2] = static_cast<std::uint8_t>(((i >> (2 * kBitsPerChannel)) & (kLevels - 1)) << kShift | half);
+    }
+
+    cv::Mat hsv;
+    cv::cvtColor(centers, hsv, cv::COLOR_BGR2HSV);
+
+    const std::uint8_t* cell = hsv.ptr<std::uint8_t>(0);
+    for (std::size_t i = 0; i < kTableSize; ++i, cell += 3) {
+        std::uint8_t label = 0;
+        for (std::size_t r = 0; r < currentRanges.size(); ++r) {
+            if (currentRanges[r].contains(cell[0], cell[1], cell[2])) {
+                label = static_cast<std::uint8_t>(r + 1);
+                break;
+            }
+        }
+        table[i] = label;
+    }
+    built = true;
+}
+
+void ColorLut::classifyStrided(const cv::Mat& bgr, cv::Mat& labels, int step) const {
+    CV_Assert(bgr.type() == CV_8UC3 && step >= 1);
+    if (step == 1) {
+        classify(bgr, labels);
+        return;
+    }
+    labels.create((bgr.rows + step - 1) / step, (bgr.cols + step - 1) / step, CV_8UC1);
+    const std::uint8_t* lut = table.data();
+    for (int y = 0; y < labels.rows; ++y) {
+        const std::uint8_t* src = bgr.ptr<std::uint8_t>(y * step);
+        std::uint8_t* dst = labels.ptr<std::uint8_t>(y);
+        for (int x = 0; x < labels.cols; ++x) {
+            const std::uint8_t* px = src + 3 * x * step;
+            dst[x] = lut[lutIndex(px[0], px[1], px[2])];
+        }
+    }
+}
+
+void ColorLut::classify(const cv::Mat& bgr, cv::Mat& labels) const {
+    CV_Assert(bgr.type() == CV_8UC3);
+    labels.create(bgr.size(), CV_8UC1);
+    for (int y = 0; y < bgr.rows; ++y) {
+        classifyRow(bgr.ptr<std::uint8_t>(y), labels.ptr<std::uint8_t>(y), bgr.cols, table.data());
+    }
+}
@@ -0,0 +1,92 @@
+#include "demo_animation.hpp"
+#include <cmath> // Para sin y cos al precalcular los clips
+#include <iostream>
+
+namespace {
+constexpr float kPi = 3.14159265f;
+// Todas las curvas de la demo son periódicas en 2*pi segundos; 189 frames son ~30 fps.
+constexpr std::size_t kDemoFrames = 189;
+constexpr float kDemoRate = static_cast<float>(kDemoFrames) / (2.f * kPi);
+
+// Pose de la animación original, relativa al centro de la ventana. `armL`/`armR` son los
+// ángulos (en grados) de los brazos; el resto del cuerpo es igual en los dos clips.
+void demoPose(float time, float armL, float armR, float* xs, float* ys) {
+    auto set = [&](JointID joint, float x, float y) {
+        xs[jointIndex(joint)] = x;
+        ys[jointIndex(joint)] = y;
+    };
+    auto get = [&](JointID joint) { return sf::Vector2f(xs[jointIndex(joint)], ys[jointIndex(joint)]); };
+
+    // Movimiento base simple (ej. torso y cabeza)
+    float bob = 10.f * std::sin(time * 2.f);
+    set(JointID::HIP_CENTER, 0.f, 60.f + bob);
+    set(JointID::TORSO_TOP, 0.f, -60.f + bob);
+    set(JointID::NECK, 0.f, -70.f + bob);
+    set(JointID::HEAD, 15.f * std::cos(time), -110.f + bob);
+
+    // Brazos
+    sf::Vector2f neck = get(JointID::NECK);
+    float radL = armL * kPi / 180.f;
+    float radR = armR * kPi / 180.f;
+    set(JointID::L_SHOULDER, neck.x - 50.f, neck.y + 5.f);
+    set(JointID::L_ELBOW, neck.x - 50.f + 40.f * std::cos(radL), neck.y + 5.f + 40.f * std::sin(radL));
+    set(JointID::L_WRIST, neck.x - 50.f + 80.f * std::cos(radL), neck.y + 5.f + 80.f * std::sin(radL));
+    set(JointID::R_SHOULDER, neck.x + 50.f, neck.y + 5.f);
+    set(JointID::R_ELBOW, neck.x + 50.f + 40.f * std::cos(radR), neck.y + 5.f + 40.f * std::sin(radR));
+    set(JointID::R_WRIST, neck.x + 50.f + 80.f * std::cos(radR), neck.y + 5.f + 80.f * std::sin(radR));
+
+    // Piernas (con un ligero balanceo)
+    sf::Vector2f hip = get(JointID::HIP_CENTER);
+    set(JointID::L_HIP, hip.x - 30.f, hip.y);
+    set(JointID::L_KNEE, hip.x - 30.f, hip.y + 60.f + 5.f * std::sin(time));
+    set(JointID::L_ANKLE, hip.x - 30.f, hip.y + 120.f + 5.f * std::sin(time));
+    set(JointID::R_HIP, hip.x + 30.f, hip.y);
+    set(JointID::R_KNEE, hip.x + 30.f, hip.y + 60.f - 5.f * std::sin(time));
+    set(JointID::R_ANKLE, hip.x + 30.f, hip.y + 120.f - 5.f * std::sin(time));
+}
+
+AnimationClip loadOrBake(const std::string& path, AnimationClip (*bake)()) {
+    AnimationClip clip;
+    if (clip.loadFromFile(path)) {
+        std::cout << "Clip cargado: " << path << " (" << clip.frameCount() << " frames)" << std::endl;
+        return clip;
+    }
+    std::cout << "Usando la versión precalculada de " << path << std::endl;
+    return bake();
+}
+}
+
+AnimationClip bakeIdleClip() {
+    return AnimationClip::bake("idle", kDemoRate, kDemoFrames, true, [](float time, float* xs, float* ys) {
+        // Brazos abajo (90 grados es hacia abajo en pantalla), con un leve vaivén
+        float sway = 8.f * std::sin(time * 2.f);
+        demoPose(time, 100.f + sway, 80.f - sway, xs, ys);
+    });
+}
+
+AnimationClip bakeWaveClip() {
+    return AnimationClip::bake("wave", kDemoRate, kDemoFrames, true, [](float time, float* xs, float* ys) {
+        // Brazos saludando
+        demoPose(time, -90.f + 45.f * std::sin(time * 3.f), -90.f - 45.f * std::sin(time * 3.f + 0.5f), xs, ys);
+    });
+}
+
+DemoClips loadDemoClips(const std::string& directory) {
+    DemoClips clips;
+    clips.idle = loadOrBake(directory + "/idle.clip", &bakeIdleClip);
+    clips.wave = loadOrBake(directory + "/wave.clip", &bakeWaveClip);
+    return clips;
+}
+
+void animateDemoFigure(StickFigure& figure, float time, sf::Vector2u windowSize) {
+    static const AnimationClip wave = bakeWaveClip();
+    float xs[kJointCount];
+    float ys[kJointCount];
+    wave.sample(time, xs, ys);
+
+    const float centerX = static_cast<float>(windowSize.x) / 2.f;
+    const float centerY = static_cast<float>(windowSize.y) / 2.f;
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        figure.setJointPosition(static_cast<JointID>(j), {centerX + xs[j], centerY + ys[j]});
+    }
+}
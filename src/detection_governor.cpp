@@ -0,0 +1,118 @@
+#include "detection_governor.hpp"
+#include <algorithm>
+
+namespace {
+// Detecciones que tienen que entrar en la media antes de decidir una bajada.
+constexpr int kMinSamples = 4;
+// La espera para volver a subir a un escalón que no se sostuvo crece hasta 2^4 veces.
+constexpr int kMaxUpgradePenalty = 4;
+}
+
+DetectionGovernor::DetectionGovernor() {
+    // De mejor a peor calidad. Cada escalón abarata un solo aspecto respecto del anterior.
+    // El primero son los ajustes por defecto de MotionCapture (seguimiento por ventanas con un
+    // escaneo completo cada 30 detecciones): sin seguimiento la detección solo sería más cara,
+    // y activar el gobernador no debe empezar por encima del coste que ya tenía. Los escalones
+    // rescan_* espacian los escaneos completos, que son lo más caro del seguimiento.
+    setLadder({
+        {"roi_tracking",          1, 1, 2, true, 30,  1},
+        {"roi_rescan_60",         1, 1, 2, true, 60,  1},
+        {"pyramid_x2",            2, 1, 2, true, 60,  1},
+        {"pyramid_x2_light",      2, 1, 1, true, 60,  1},
+        {"pyramid_x4",            4, 1, 1, true, 60,  1},
+        {"pyramid_x4_rescan_120", 4, 1, 1, true, 120, 1},
+        {"pyramid_x4_every_2",    4, 1, 1, true, 120, 2},
+        {"pyramid_x4_every_3",    4, 1, 1, true, 120, 3},
+    });
+}
+
+void DetectionGovernor::setLadder(std::vector<DetectionQuality> ladder) {
+    if (ladder.empty()) {
+        return; // Siempre hay al menos un escalón
+    }
+    levels = std::move(ladder);
+    upgradePenalty.assign(levels.size(), 0);
+    reset(0);
+}
+
+void DetectionGovernor::reset(int startLevel) {
+    std::fill(upgradePenalty.begin(), upgradePenalty.end(), 0);
+    changeLevel(std::clamp(startLevel, 0, static_cast<int>(levels.size()) - 1));
+}
+
+void DetectionGovernor::changeLevel(int next) {
+    current = next;
+    settleRemaining = settleFrames;
+    headroomFrames = 0;
+    framesAtLevel = 0;
+    upgradedIntoCurrent = false;
+    averagedSamples = 0;
+    average = 0.0;
+    publishedLevel.store(current, std::memory_order_relaxed);
+}
+
+bool DetectionGovernor::record(std::chrono::steady_clock::duration elapsed, int framesPerDetection) {
+    const double ms = std::chrono::duration<double, std::milli>(elapsed).count() / std::max(1, framesPerDetection);
+    measured.fetch_add(1, std::memory_order_relaxed);
+    if (ms > budgetMs) {
+        overBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Una subida que aguanta el doble de la espera se da por buena y su penalización se olvida.
+    if (upgradedIntoCurrent && ++framesAtLevel >= 2 * upgradeHoldFrames) {
+        upgradePenalty[static_cast<std::size_t>(current)] = 0;
+        upgradedIntoCurrent = false;
+    }
+    if (settleRemaining > 0) {
+        --settleRemaining;
+        return false;
+    }
+
+    average = averagedSamples == 0 ? ms : average + smoothing * (ms - average);
+    ++averagedSamples;
+    publishedAverage.store(average, std::memory_order_relaxed);
+
+    const int last = static_cast<int>(levels.size()) - 1;
+    if (averagedSamples >= kMinSamples && average > budgetMs && current < last) {
+        if (upgradedIntoCurrent) {
+            int& penalty = upgradePenalty[static_cast<std::size_t>(current)];
+            penalty = std::min(penalty + 1, kMaxUpgradePenalty);
+        }
+        changeLevel(current + 1);
+        downgradeCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (current > 0 && average < budgetMs * upgradeHeadroom) {
+        const int wait = upgradeHoldFrames << upgradePenalty[static_cast<std::size_t>(current - 1)];
+        if (++headroomFrames >= wait) {
+            changeLevel(current - 1);
+            upgradedIntoCurrent = true;
+            upgradeCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    } else {
+        headroomFrames = 0;
+    }
+    return false;
+}
+
+void DetectionGovernor::apply(MotionCapture& tracker) const {
+    const DetectionQuality& q = quality();
+    tracker.pyramidScale = q.pyramidScale;
+    tracker.erodeIterations = q.erodeIterations;
+    tracker.dilateIterations = q.dilateIterations;
+    tracker.roiTrackingEnabled = q.roiTracking;
+    tracker.fullScanInterval = q.fullScanInterval;
+}
+
+DetectionGovernor::Stats DetectionGovernor::stats() const {
+    Stats s;
+    s.framesMeasured = measured.load(std::memory_order_relaxed);
+    s.framesOverBudget = overBudget.load(std::memory_order_relaxed);
+    s.downgrades = downgradeCount.load(std::memory_order_relaxed);
+    s.upgrades = upgradeCount.load(std::memory_order_relaxed);
+    s.level = publishedLevel.load(std::memory_order_relaxed);
+    s.averageMs = publishedAverage.load(std::memory_order_relaxed);
+    return s;
+}
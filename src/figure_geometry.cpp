@@ -0,0 +1,71 @@
+#include "figure_geometry.hpp"
+#include <cmath>
+
+namespace figure_geometry {
+
+namespace {
+
+struct UnitCircle {
+    std::array<float, kCircleSegments + 1> cosines;
+    std::array<float, kCircleSegments + 1> sines;
+
+    UnitCircle() {
+        for (std::size_t i = 0; i <= kCircleSegments; ++i) {
+            float angle = 2.f * 3.14159265f * static_cast<float>(i) / static_cast<float>(kCircleSegments);
+            cosines[i] = std::cos(angle);
+            sines[i] = std::sin(angle);
+        }
+    }
+};
+
+const UnitCircle kUnitCircle;
+
+inline void setVertex(sf::Vertex& vertex, float x, float y, sf::Color color) {
+    vertex.position = sf::Vector2f(x, y);
+    vertex.color = color;
+}
+
+} // namespace
+
+void writeFigure(const float* xs, const float* ys, std::size_t stride, sf::Vertex* out, float scale) {
+    sf::Vertex* v = out;
+
+    for (const Bone& bone : kBones) {
+        const float x1 = xs[jointIndex(bone.joint1) * stride];
+        const float y1 = ys[jointIndex(bone.joint1) * stride];
+        const float x2 = xs[jointIndex(bone.joint2) * stride];
+        const float y2 = ys[jointIndex(bone.joint2) * stride];
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        const float length = std::sqrt(dx * dx + dy * dy);
+
+        // Normal al hueso de largo thickness / 2. Un hueso de largo 0 queda degenerado (invisible).
+        float nx = 0.f, ny = 0.f;
+        if (length > 0.f) {
+            const float k = 0.5f * bone.thickness * scale / length;
+            nx = -dy * k;
+            ny = dx * k;
+        }
+        setVertex(v[0], x1 + nx, y1 + ny, bone.color);
+        setVertex(v[1], x1 - nx, y1 - ny, bone.color);
+        setVertex(v[2], x2 + nx, y2 + ny, bone.color);
+        setVertex(v[3], x2 + nx, y2 + ny, bone.color);
+        setVertex(v[4], x1 - nx, y1 - ny, bone.color);
+        setVertex(v[5], x2 - nx, y2 - ny, bone.color);
+        v += kVerticesPerBone;
+    }
+
+    const float radius = kJointRadius * scale;
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        const float cx = xs[j * stride];
+        const float cy = ys[j * stride];
+        for (std::size_t s = 0; s < kCircleSegments; ++s) {
+            setVertex(v[0], cx, cy, sf::Color::Red);
+            setVertex(v[1], cx + radius * kUnitCircle.cosines[s], cy + radius * kUnitCircle.sines[s], sf::Color::Red);
+            setVertex(v[2], cx + radius * kUnitCircle.cosines[s + 1], cy + radius * kUnitCircle.sines[s + 1], sf::Color::Red);
+            v += 3;
+        }
+    }
+}
+
+} // namespace figure_geometry
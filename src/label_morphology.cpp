@@ -0,0 +1,74 @@
+#include "label_morphology.hpp"
+#include "work_buffer.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+struct MinOp {
+    std::uint8_t operator()(std::uint8_t a, std::uint8_t b) const { return std::min(a, b); }
+};
+struct MaxOp {
+    std::uint8_t operator()(std::uint8_t a, std::uint8_t b) const { return std::max(a, b); }
+};
+
+// dst[x] = op(dst[x], src[x]) para toda la fila (el compilador lo vectoriza).
+template <typename Op>
+inline void combineRow(std::uint8_t* __restrict dst, const std::uint8_t* __restrict src, int width, Op op) {
+    for (int x = 0; x < width; ++x) {
+        dst[x] = op(dst[x], src[x]);
+    }
+}
+}
+
+template <typename Op>
+void LabelMorphology::apply(cv::Mat& labels, int kernelSize, Op op) {
+    CV_Assert(labels.type() == CV_8UC1 && (kernelSize == 3 || kernelSize == 5));
+    const int rows = labels.rows;
+    const int cols = labels.cols;
+    const int radius = kernelSize / 2;     // Rectángulo alto: 1 x kernelSize
+    const int wideRadius = radius - 1;     // Rectángulo ancho: kernelSize x (kernelSize - 2)
+
+    cv::Mat source = workBuffer(sourceStorage, labels.size(), CV_8UC1);
+    cv::Mat horizontal = workBuffer(horizontalStorage, labels.size(), CV_8UC1);
+    for (int y = 0; y < rows; ++y) {
+        std::copy_n(labels.ptr<std::uint8_t>(y), cols, source.ptr<std::uint8_t>(y));
+    }
+
+    // Pasada horizontal del rectángulo ancho; los vecinos fuera de la imagen se ignoran.
+    for (int y = 0; y < rows; ++y) {
+        const std::uint8_t* s = source.ptr<std::uint8_t>(y);
+        std::uint8_t* h = horizontal.ptr<std::uint8_t>(y);
+        std::copy_n(s, cols, h);
+        for (int d = 1; d <= radius && d < cols; ++d) {
+            combineRow(h + d, s, cols - d, op);  // vecino izquierdo
+            combineRow(h, s + d, cols - d, op);  // vecino derecho
+        }
+    }
+
+    // Pasada vertical de ambos rectángulos, escribiendo sobre la entrada.
+    for (int y = 0; y < rows; ++y) {
+        std::uint8_t* out = labels.ptr<std::uint8_t>(y);
+        std::copy_n(horizontal.ptr<std::uint8_t>(y), cols, out);
+        for (int d = 1; d <= wideRadius; ++d) {
+            if (y - d >= 0) combineRow(out, horizontal.ptr<std::uint8_t>(y - d), cols, op);
+            if (y + d < rows) combineRow(out, horizontal.ptr<std::uint8_t>(y + d), cols, op);
+        }
+        // La columna central del rectángulo alto en la fila y ya está incluida en la pasada horizontal.
+        for (int d = 1; d <= radius; ++d) {
+            if (y - d >= 0) combineRow(out, source.ptr<std::uint8_t>(y - d), cols, op);
+            if (y + d < rows) combineRow(out, source.ptr<std::uint8_t>(y + d), cols, op);
+        }
+    }
+}
+
+void LabelMorphology::erode(cv::Mat& labels, int kernelSize, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        apply(labels, kernelSize, MinOp{});
+    }
+}
+
+void LabelMorphology::dilate(cv::Mat& labels, int kernelSize, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        apply(labels, kernelSize, MaxOp{});
+    }
+}
@@ -1,91 +1,145 @@
 
 #include <SFML/Graphics.hpp>
 #include "stick_figure.hpp"
+#include "animation_mixer.hpp"
+#include "demo_animation.hpp"
 #include "motion_capture.hpp"
+#include "multi_source_capture.hpp"
+#include "capture_pipeline.hpp"
+#include "offline_processor.hpp"
+#include "parallel_for.hpp"
+#include "pose_batch.hpp"
+#include "pose_detector.hpp"
+#include "pose_filter.hpp"
+#include "pose_shm_publisher.hpp"
+#include "pose_track.hpp"
+#include "video_exporter.hpp"
+#include "profiler_overlay.hpp"
+#include "stage_profiler.hpp"
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <string>
-#include <cmath> // Para sin y cos en la demo
-
-
-// Este mapa es CRUCIAL para el modo de captura de color.
-// Asocia el ÍNDICE del objeto azul detectado (0, 1, 2...) con una JointID.
-// El orden de detección de OpenCV (después de cualquier filtrado/ordenamiento que añadas)
-// determinará qué objeto azul es el índice 0, cuál el 1, etc.
-// DEBES colocar tus cintas azules en un orden que corresponda a este mapa.
-// Ejemplo: si pones una cinta en tu cabeza, otra en tu mano izq, y otra en tu mano der,
-// y esperas que se detecten en ESE orden, el mapa sería:
-// {0, JointID::HEAD}, {1, JointID::L_WRIST}, {2, JointID::R_WRIST}
-// ¡AJUSTA ESTO CUIDADOSAMENTE!
-const std::map<int, JointID> COLOR_INDEX_TO_JOINT_MAP = {
-    {0, JointID::HEAD},
-    {1, JointID::L_WRIST},
-    {2, JointID::R_WRIST},
-    // Añade más si vas a usar más marcadores de cinta azul
-    // Por ejemplo, si usas 5 marcadores:
-    // {3, JointID::L_ELBOW},
-    // {4, JointID::R_ELBOW}
-    // {0, JointID::NECK}, // O quizás un marcador en el pecho para TORSO_TOP
-    // {1, JointID::L_SHOULDER},
-    // {2, JointID::R_SHOULDER},
-    // {3, JointID::HIP_CENTER}
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+// La asociación marcador -> articulación ya no depende del orden de detección:
+// cada color de cinta está ligado a una JointID en MotionCapture::markerColors
+// (por defecto azul = cabeza, verde = muñeca izquierda, rojo = muñeca derecha).
+// ¡AJUSTA LOS RANGOS HSV A TUS CINTAS!
+
+// Fuente de movimiento del personaje
+enum class AppMode {
+    Demo,     // Animación de demostración (sin cámara)
+    Live,     // Captura en vivo
+    Playback, // Reproducción de una pista de pose grabada (.ptrk)
 };
 
 // Variables para el modo Demo
-bool demoModeActive = true; // Empezar en modo demo para verificar esqueleto
-float demoTime = 0.0f;
-sf::Clock demoClock; // Para el tiempo de la demo
-
-// Función para la animación de demostración
-void animateDemoFigure(StickFigure& figure, float time, sf::Vector2u windowSize) {
-    float centerX = static_cast<float>(windowSize.x) / 2.f;
-    float centerY = static_cast<float>(windowSize.y) / 2.f;
-
-    // Movimiento base simple (ej. torso y cabeza)
-    figure.setJointPosition(JointID::HIP_CENTER, {centerX, centerY + 60.f + 10.f * std::sin(time * 2.f)});
-    figure.setJointPosition(JointID::TORSO_TOP, {centerX, centerY - 60.f + 10.f * std::sin(time * 2.f)});
-    figure.setJointPosition(JointID::NECK, {centerX, centerY - 70.f + 10.f * std::sin(time * 2.f)});
-    figure.setJointPosition(JointID::HEAD, {centerX + 15.f * std::cos(time), centerY - 110.f + 10.f * std::sin(time * 2.f)});
-
-    // Brazos saludando
-    float armAngleL = -90.f + 45.f * std::sin(time * 3.f); // Ángulo en grados
-    float armAngleR = -90.f - 45.f * std::sin(time * 3.f + 0.5f);
-
-    sf::Vector2f neckPos = figure.getJointPosition(JointID::NECK); // Usar como referencia
-
-    figure.setJointPosition(JointID::L_SHOULDER, {neckPos.x - 50.f, neckPos.y + 5.f});
-    sf::Vector2f lShoulderPos = figure.getJointPosition(JointID::L_SHOULDER);
-    figure.setJointPosition(JointID::L_ELBOW, {lShoulderPos.x + 40.f * std::cos(armAngleL * 3.14159f / 180.f),
-                                               lShoulderPos.y + 40.f * std::sin(armAngleL * 3.14159f / 180.f)});
-    sf::Vector2f lElbowPos = figure.getJointPosition(JointID::L_ELBOW);
-    figure.setJointPosition(JointID::L_WRIST, {lElbowPos.x + 40.f * std::cos(armAngleL * 3.14159f / 180.f),
-                                               lElbowPos.y + 40.f * std::sin(armAngleL * 3.14159f / 180.f)});
-
-
-    figure.setJointPosition(JointID::R_SHOULDER, {neckPos.x + 50.f, neckPos.y + 5.f});
-    sf::Vector2f rShoulderPos = figure.getJointPosition(JointID::R_SHOULDER);
-    figure.setJointPosition(JointID::R_ELBOW, {rShoulderPos.x + 40.f * std::cos(armAngleR * 3.14159f / 180.f),
-                                               rShoulderPos.y + 40.f * std::sin(armAngleR * 3.14159f / 180.f)});
-    sf::Vector2f rElbowPos = figure.getJointPosition(JointID::R_ELBOW);
-    figure.setJointPosition(JointID::R_WRIST, {rElbowPos.x + 40.f * std::cos(armAngleR * 3.14159f / 180.f),
-                                               rElbowPos.y + 40.f * std::sin(armAngleR * 3.14159f / 180.f)});
-
-
-    // Piernas (mantenerlas simples o con un ligero balanceo)
-    figure.setJointPosition(JointID::L_HIP, {figure.getJointPosition(JointID::HIP_CENTER).x - 30.f, figure.getJointPosition(JointID::HIP_CENTER).y});
-    figure.setJointPosition(JointID::L_KNEE, {figure.getJointPosition(JointID::L_HIP).x, figure.getJointPosition(JointID::L_HIP).y + 60.f + 5.f * std::sin(time)});
-    figure.setJointPosition(JointID::L_ANKLE, {figure.getJointPosition(JointID::L_KNEE).x, figure.getJointPosition(JointID::L_KNEE).y + 60.f});
-
-    figure.setJointPosition(JointID::R_HIP, {figure.getJointPosition(JointID::HIP_CENTER).x + 30.f, figure.getJointPosition(JointID::HIP_CENTER).y});
-    figure.setJointPosition(JointID::R_KNEE, {figure.getJointPosition(JointID::R_HIP).x, figure.getJointPosition(JointID::R_HIP).y + 60.f - 5.f * std::sin(time)});
-    figure.setJointPosition(JointID::R_ANKLE, {figure.getJointPosition(JointID::R_KNEE).x, figure.getJointPosition(JointID::R_KNEE).y + 60.f});
+AppMode appMode = AppMode::Demo; // Empezar en modo demo para verificar esqueleto
+
+// Reparte `count` figuras en una cuadrícula que cubre la ventana, cada una con su desfase.
+void buildCrowd(PoseBatch& crowd, std::size_t count, sf::Vector2u windowSize) {
+    crowd.clear();
+    crowd.reserve(count);
+    std::size_t columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count) * windowSize.x / windowSize.y)));
+    columns = std::max<std::size_t>(columns, 1);
+    std::size_t rows = (count + columns - 1) / columns;
+    float cellW = static_cast<float>(windowSize.x) / static_cast<float>(columns);
+    float cellH = static_cast<float>(windowSize.y) / static_cast<float>(rows);
+    float scale = std::min(cellW, cellH) / 400.f; // La figura mide unos 400 px a escala 1
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t row = i / columns;
+        std::size_t col = i % columns;
+        crowd.addFigure({(static_cast<float>(col) + 0.5f) * cellW, (static_cast<float>(row) + 0.55f) * cellH},
+                        scale, static_cast<std::uint32_t>((i * 7) % PoseBatch::kHistoryLength));
+    }
 }
 
 
-int main() {
+int main(int argc, char** argv) {
     unsigned int windowWidth = 1024;
     unsigned int windowHeight = 768;
+
+    std::size_t crowdSize = 1000; // Figuras en el modo multitud (--crowd N)
+    std::string playbackPath;     // Pista de pose para el modo reproducción (--play archivo.ptrk)
+    std::string profileCsvPath = "profile.csv"; // Volcado de latencias por etapa al salir (--profile-csv archivo)
+    int detectionInterval = 1;    // Detectar uno de cada N frames de cámara (--detect-every N)
+    double detectionBudgetMs = 0.0; // Presupuesto de detección por frame; > 0 activa el gobernador (--budget ms)
+    std::string detectorName = "color"; // Detector del modo Captura: color | silhouette (--detector nombre)
+    std::string shmName;          // Publicar las poses en memoria compartida (--shm nombre)
+    std::vector<CaptureSourceConfig> extraSources; // Varias cámaras o videos a la vez (--source índice|archivo, repetible)
+    OfflineOptions offlineOptions; // Modo sin ventana: --input video [--output poses.csv] [--workers N] [--no-mirror]
+    ExportOptions exportOptions;   // Exportar a video sin ventana: --export video.avi [--play pista.ptrk] [--export-seconds S] [--export-fps F]
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--crowd") == 0 && i + 1 < argc) {
+            crowdSize = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            offlineOptions.inputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            offlineOptions.outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            offlineOptions.workers = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            exportOptions.outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--export-seconds") == 0 && i + 1 < argc) {
+            exportOptions.demoSeconds = std::max(0.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--export-fps") == 0 && i + 1 < argc) {
+            exportOptions.fps = std::max(1.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--play") == 0 && i + 1 < argc) {
+            playbackPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profileCsvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--detect-every") == 0 && i + 1 < argc) {
+            detectionInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            detectionBudgetMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--pyramid") == 0 && i + 1 < argc) {
+            offlineOptions.pyramidScale = std::atoi(argv[++i]);
+            if (offlineOptions.pyramidScale != 1 && offlineOptions.pyramidScale != 2 && offlineOptions.pyramidScale != 4) {
+                std::cerr << "ERROR: Escala piramidal no válida: " << argv[i] << " (1 | 2 | 4)" << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--detector") == 0 && i + 1 < argc) {
+            detectorName = argv[++i];
+        } else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shmName = argv[++i];
+        } else if (std::strcmp(argv[i], "--source") == 0 && i + 1 < argc) {
+            CaptureSourceConfig source;
+            const char* value = argv[++i];
+            char* end = nullptr;
+            long cameraIndex = std::strtol(value, &end, 10);
+            if (*value != '\0' && *end == '\0') {
+                source.cameraIndex = static_cast<int>(cameraIndex);
+            } else {
+                source.path = value;
+            }
+            extraSources.push_back(source);
+        } else if (std::strcmp(argv[i], "--no-mirror") == 0) {
+            offlineOptions.mirror = false;
+        }
+    }
+
+    // Sin ventana ni cámara: procesar el archivo y salir.
+    if (!offlineOptions.inputPath.empty()) {
+        OfflineProcessor processor(offlineOptions);
+        return processor.run() ? 0 : 1;
+    }
+    // Sin ventana: dibujar la pista (o la demo) fuera de pantalla y escribirla como video.
+    if (!exportOptions.outputPath.empty()) {
+        exportOptions.trackPath = playbackPath;
+        exportOptions.width = windowWidth;
+        exportOptions.height = windowHeight;
+        VideoExporter exporter(exportOptions);
+        return exporter.run() ? 0 : 1;
+    }
     sf::RenderWindow window(sf::VideoMode(sf::Vector2<unsigned int>(windowWidth, windowHeight)),
                             "Stick Figure Animation with Motion Capture",
                             sf::Style::Default);
@@ -95,6 +149,74 @@ int main() {
     playerFigure.initialize(window.getSize()); // Inicializa en T-Pose
 
     MotionCapture motionTracker;
+    motionTracker.pyramidScale = offlineOptions.pyramidScale;
+    // Captura y detección corren en sus propios hilos; el bucle de render solo consume la última pose.
+    CapturePipeline capturePipeline(motionTracker);
+    capturePipeline.setDetectionInterval(detectionInterval);
+    if (detectionBudgetMs > 0.0) {
+        capturePipeline.governor().budgetMs = detectionBudgetMs;
+        capturePipeline.setGovernorEnabled(true);
+    }
+    // Detector sin marcadores (--detector silhouette o tecla K); los marcadores de color son
+    // los del propio motionTracker.
+    std::unique_ptr<PoseDetector> markerlessDetector;
+    if (detectorName != "color") {
+        markerlessDetector = makePoseDetector(detectorName);
+        if (!markerlessDetector) {
+            std::cerr << "ERROR: Detector desconocido: " << detectorName << " (color | silhouette)" << std::endl;
+            return 1;
+        }
+        if (!extraSources.empty()) {
+            std::cerr << "ERROR: Con --source solo se pueden usar los marcadores de color (--detector color)" << std::endl;
+            return 1;
+        }
+        capturePipeline.setDetector(markerlessDetector.get());
+    }
+    bool markerlessActive = markerlessDetector != nullptr;
+
+    // Con --source, el modo Captura usa todas las fuentes a la vez; el personaje sigue a una.
+    MultiSourceCapture multiCapture(extraSources.empty() ? 1 : 0);
+    for (CaptureSourceConfig& source : extraSources) {
+        source.mirror = offlineOptions.mirror;
+        source.pyramidScale = offlineOptions.pyramidScale;
+        multiCapture.addSource(source);
+    }
+    std::size_t shownSource = 0;
+
+    // Anillos en memoria compartida para otros procesos: uno por fuente (<nombre>, <nombre>_1...).
+    // Se escriben desde los hilos de detección en cuanto se resuelve cada pose.
+    std::vector<std::unique_ptr<PoseShmPublisher>> shmPublishers;
+    if (!shmName.empty()) {
+        std::size_t rings = std::max<std::size_t>(1, multiCapture.sourceCount());
+        for (std::size_t i = 0; i < rings; ++i) {
+            auto publisher = std::make_unique<PoseShmPublisher>();
+            if (publisher->open(i == 0 ? shmName : shmName + "_" + std::to_string(i))) {
+                shmPublishers.push_back(std::move(publisher));
+            }
+        }
+        if (shmPublishers.size() == rings) {
+            capturePipeline.setPoseCallback([&shmPublishers](const PosePacket& packet) {
+                shmPublishers[0]->publish(packet.pose, packet.captureTime);
+            });
+            multiCapture.setPoseCallback([&shmPublishers](std::size_t source, const PosePacket& packet) {
+                shmPublishers[source]->publish(packet.pose, packet.captureTime);
+            });
+        }
+    }
+
+    // Filtro temporal: desacopla la frecuencia de render de la de captura/detección.
+    PoseFilter poseFilter;
+    DetectedPose livePose; // Última pose en vivo (filtrada o tal cual llegó)
+    bool poseFilterEnabled = true;
+
+    // Clips de animación: el modo Demo los reproduce y, en modo Captura, pueden completar
+    // las articulaciones que no tienen marcador.
+    DemoClips demoClips = loadDemoClips();
+    AnimationMixer demoMixer;
+    demoMixer.crossfadeTo(&demoClips.wave, 0.f);
+    DetectedPose animatedPose;
+    bool clipBlendEnabled = false;
+    sf::Clock frameClock;
     // No inicializar cámara si empezamos en modo demo sin cámara
     // if (!motionTracker.initializeCamera(0)) {
     //     std::cerr << "Fallo al inicializar la cámara. Saliendo." << std::endl;
@@ -106,11 +228,51 @@ int main() {
     std::cout << "  M: Cambiar Modo (Demo / Captura en Vivo)" << std::endl;
     std::cout << "  D: Mostrar/Ocultar vista de cámara OpenCV (debug, solo en modo Captura)" << std::endl;
     std::cout << "  S: Mostrar/Ocultar máscara de color en vista OpenCV (cuando D está activa)" << std::endl;
+    std::cout << "  C: Mostrar/Ocultar multitud (" << crowdSize << " figuras, --crowd N)" << std::endl;
+    std::cout << "  R: Grabar/Detener grabación de la pose (solo en modo Captura)" << std::endl;
+    std::cout << "  P: Reproducir pista de pose (--play archivo.ptrk); Izq/Der: -5 s / +5 s" << std::endl;
+    std::cout << "  L: Mostrar/Ocultar latencias por etapa (p50/p95/p99)" << std::endl;
+    std::cout << "  F: Activar/Desactivar filtro de predicción de articulaciones" << std::endl;
+    std::cout << "  N: Cambiar intervalo de detección (1-4 frames de cámara)" << std::endl;
+    std::cout << "  G: Activar/Desactivar el gobernador del presupuesto de detección (--budget ms)" << std::endl;
+    std::cout << "  K: Cambiar el detector (marcadores de color / silueta sin marcadores, --detector)" << std::endl;
+    std::cout << "  V: Cambiar la fuente que sigue el personaje (con varias --source)" << std::endl;
+    std::cout << "  W: Fundido entre los clips de reposo y saludo" << std::endl;
+    std::cout << "  B: Completar con el clip las articulaciones sin marcador (solo en modo Captura)" << std::endl;
+
+    // Grabación y reproducción de pistas de pose
+    PoseTrackWriter poseRecorder;
+    PipelineClock::time_point recordingStart{};
+    PoseTrackReader posePlayer;
+    if (!playbackPath.empty() && posePlayer.open(playbackPath)) {
+        std::cout << "Pista cargada: " << posePlayer.frameCount() << " frames a " << posePlayer.frameRate() << " fps." << std::endl;
+    }
+    sf::Clock playbackClock;
+    float playbackOffset = 0.f; // Segundos añadidos al reloj al saltar con las flechas
+
+    // Modo multitud: muchas figuras que imitan al personaje principal con desfases distintos.
+    ParallelFor crowdWorkers;
+    PoseBatch crowd;
+    bool crowdModeActive = false;
+
+    ProfilerOverlay profilerOverlay;
+    profilerOverlay.setStatusSource([&capturePipeline]() -> std::string {
+        if (!capturePipeline.isGovernorEnabled()) {
+            return {};
+        }
+        const DetectionGovernor& governor = capturePipeline.governor();
+        DetectionGovernor::Stats g = governor.stats();
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer),
+                      "gobernador: %s (%.2f / %.2f ms)\n  medidas %llu  sobre presupuesto %llu  bajadas %llu  subidas %llu\n",
+                      governor.ladder()[static_cast<std::size_t>(g.level)].name, g.averageMs, governor.budgetMs,
+                      static_cast<unsigned long long>(g.framesMeasured), static_cast<unsigned long long>(g.framesOverBudget),
+                      static_cast<unsigned long long>(g.downgrades), static_cast<unsigned long long>(g.upgrades));
+        return buffer;
+    });
     // bool showDebugCVView = false;
     // bool showColorMaskInDebug = false;
 
-    demoClock.restart(); // Inicia el reloj para la demo
-
     // while (window.isOpen()) {
     //     sf::Event event;
     //     while (window.pollEvent(event)) {
@@ -214,17 +376,211 @@ int main() {
                 {
                     window.close();
                 }
+                if (keyPressed->code == sf::Keyboard::Key::M)
+                {
+                    if (appMode == AppMode::Live) {
+                        std::cout << "Modo Demo ACTIVADO." << std::endl;
+                        poseRecorder.close();
+                        capturePipeline.stop(); // Apagar cámara si estaba encendida
+                        multiCapture.stop();
+                        appMode = AppMode::Demo;
+                    } else {
+                        std::cout << "Modo Captura en Vivo ACTIVADO." << std::endl;
+                        poseFilter.reset();
+                        livePose.clear();
+                        bool started = multiCapture.sourceCount() > 0 ? multiCapture.start() : capturePipeline.start(0);
+                        if (started) {
+                            appMode = AppMode::Live;
+                        } else {
+                            std::cerr << "Fallo al inicializar cámara para modo en vivo. Volviendo a modo Demo." << std::endl;
+                            appMode = AppMode::Demo;
+                        }
+                    }
+                    playerFigure.initialize(window.getSize()); // Reiniciar a T-pose
+                }
+                if (keyPressed->code == sf::Keyboard::Key::P)
+                {
+                    if (!posePlayer.isOpen() || posePlayer.frameCount() == 0) {
+                        std::cout << "No hay pista de pose cargada (usa --play archivo.ptrk)." << std::endl;
+                    } else if (appMode == AppMode::Playback) {
+                        std::cout << "Modo Demo ACTIVADO." << std::endl;
+                        appMode = AppMode::Demo;
+                    } else {
+                        std::cout << "Modo Reproducción ACTIVADO." << std::endl;
+                        poseRecorder.close();
+                        capturePipeline.stop();
+                        multiCapture.stop();
+                        appMode = AppMode::Playback;
+                        playbackClock.restart();
+                        playbackOffset = 0.f;
+                    }
+                    playerFigure.initialize(window.getSize());
+                }
+                if (appMode == AppMode::Playback && keyPressed->code == sf::Keyboard::Key::Left)
+                {
+                    playbackOffset -= 5.f;
+                }
+                if (appMode == AppMode::Playback && keyPressed->code == sf::Keyboard::Key::Right)
+                {
+                    playbackOffset += 5.f;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::R)
+                {
+                    if (poseRecorder.isOpen()) {
+                        std::cout << "Grabación detenida (" << poseRecorder.frameCount() << " frames)." << std::endl;
+                        poseRecorder.close();
+                    } else if (appMode == AppMode::Live) {
+                        std::string path = "session_" + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count()) + ".ptrk";
+                        // 30 fps es solo provisional: al cerrar se guarda la frecuencia media real.
+                        if (poseRecorder.open(path, 30.0)) {
+                            recordingStart = PipelineClock::now();
+                            std::cout << "Grabando en " << path << std::endl;
+                        }
+                    } else {
+                        std::cout << "La grabación solo está disponible en modo Captura (presiona M)." << std::endl;
+                    }
+                }
+                if (keyPressed->code == sf::Keyboard::Key::L)
+                {
+                    profilerOverlay.toggle();
+                }
+                if (keyPressed->code == sf::Keyboard::Key::F)
+                {
+                    poseFilterEnabled = !poseFilterEnabled;
+                    poseFilter.reset();
+                    livePose.clear();
+                    std::cout << "Filtro de predicción: " << (poseFilterEnabled ? "Sí" : "No") << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::N)
+                {
+                    int interval = capturePipeline.getDetectionInterval() % 4 + 1;
+                    capturePipeline.setDetectionInterval(interval);
+                    std::cout << "Detectando 1 de cada " << interval << " frames de cámara." << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::G)
+                {
+                    capturePipeline.setGovernorEnabled(!capturePipeline.isGovernorEnabled());
+                    std::cout << "Gobernador de detección: " << (capturePipeline.isGovernorEnabled() ? "Sí" : "No")
+                              << " (presupuesto " << capturePipeline.governor().budgetMs << " ms)" << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::K && multiCapture.sourceCount() > 0)
+                {
+                    std::cout << "Con varias fuentes (--source) solo se pueden usar los marcadores de color." << std::endl;
+                }
+                else if (keyPressed->code == sf::Keyboard::Key::K)
+                {
+                    // El detector de silueta vuelve a aprender el fondo cada vez que se activa.
+                    if (!markerlessDetector) {
+                        markerlessDetector = makePoseDetector("silhouette");
+                    }
+                    markerlessActive = !markerlessActive;
+                    capturePipeline.setDetector(markerlessActive ? markerlessDetector.get() : nullptr);
+                    poseFilter.reset();
+                    livePose.clear();
+                    std::cout << "Detector: " << (markerlessActive ? markerlessDetector->name() : motionTracker.name()) << std::endl;
+                    if (markerlessActive) {
+                        std::cout << "Sal del encuadre un momento para que aprenda el fondo." << std::endl;
+                    }
+                }
+                if (keyPressed->code == sf::Keyboard::Key::V && multiCapture.sourceCount() > 1)
+                {
+                    shownSource = (shownSource + 1) % multiCapture.sourceCount();
+                    poseFilter.reset();
+                    livePose.clear();
+                    std::cout << "Siguiendo la fuente " << shownSource << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::W)
+                {
+                    const AnimationClip* next = demoMixer.dominantClip() == &demoClips.wave ? &demoClips.idle : &demoClips.wave;
+                    demoMixer.crossfadeTo(next, 0.5f);
+                    std::cout << "Clip: " << next->name() << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::B)
+                {
+                    clipBlendEnabled = !clipBlendEnabled;
+                    std::cout << "Completar articulaciones con el clip: " << (clipBlendEnabled ? "Sí" : "No") << std::endl;
+                }
+                if (keyPressed->code == sf::Keyboard::Key::C)
+                {
+                    crowdModeActive = !crowdModeActive;
+                    if (crowdModeActive && crowd.size() != crowdSize) {
+                        buildCrowd(crowd, crowdSize, window.getSize());
+                    }
+                    std::cout << "Modo multitud: " << (crowdModeActive ? "Sí" : "No") << std::endl;
+                }
+            }
+        }
+
+        demoMixer.update(frameClock.restart().asSeconds());
+        sf::Vector2f figureCenter(static_cast<float>(window.getSize().x) / 2.f, static_cast<float>(window.getSize().y) / 2.f);
+
+        std::optional<PipelineClock::time_point> shownCaptureTime; // Captura de la pose nueva de este frame
+        if (appMode == AppMode::Demo) {
+            demoMixer.evaluate(figureCenter, 1.f, animatedPose);
+            playerFigure.updatePose(animatedPose);
+        } else if (appMode == AppMode::Live) {
+            const PosePacket* packet = multiCapture.isRunning() ? multiCapture.latestPose(shownSource) : capturePipeline.latestPose();
+            if (packet) {
+                if (poseFilterEnabled) {
+                    poseFilter.addSample(packet->pose, packet->captureTime);
+                } else {
+                    // Sin filtro, si no llegó una pose nueva el personaje mantiene la última.
+                    livePose = packet->pose;
+                }
+                shownCaptureTime = packet->captureTime;
+                if (poseRecorder.isOpen()) {
+                    auto sinceStart = std::chrono::duration_cast<std::chrono::microseconds>(packet->captureTime - recordingStart);
+                    poseRecorder.append(packet->pose, sinceStart.count());
+                }
+            }
+            if (poseFilterEnabled) {
+                // Pose estimada para el instante de presentación de este frame.
+                poseFilter.sample(PipelineClock::now(), livePose);
             }
+            if (clipBlendEnabled) {
+                // overlayLivePose lleva el clip al espacio de la cámara antes de mezclar.
+                demoMixer.evaluate(figureCenter, 1.f, animatedPose);
+                overlayLivePose(livePose, animatedPose);
+                playerFigure.updatePose(animatedPose);
+            } else {
+                playerFigure.updatePose(livePose);
+            }
+        } else {
+            // Reproducción en bucle según los timestamps grabados (la detección no va a frecuencia
+            // fija); el frame se lee directamente del archivo mapeado.
+            double duration = posePlayer.duration();
+            double t = std::fmod(playbackClock.getElapsedTime().asSeconds() + playbackOffset, duration);
+            if (t < 0.0) t += duration;
+            playerFigure.updatePose(posePlayer.frame(posePlayer.frameIndexAt(t)).pose);
         }
 
-        demoTime = demoClock.getElapsedTime().asSeconds();
-        animateDemoFigure(playerFigure, demoTime, window.getSize());
+        if (crowdModeActive) {
+            crowd.pushSourcePose(playerFigure.joints());
+            crowd.update(crowdWorkers);
+        }
 
         window.clear(sf::Color(220, 220, 220));
+        if (crowdModeActive) {
+            crowd.draw(window);
+        }
         playerFigure.draw(window);
-        window.display();
+        profilerOverlay.draw(window);
+        {
+            PROFILE_STAGE(Present);
+            window.display();
+        }
+        if (shownCaptureTime) {
+            PROFILE_RECORD(CaptureToPresent, PipelineClock::now() - *shownCaptureTime);
+        }
     }
 
+    poseRecorder.close();
+    capturePipeline.stop();
+    multiCapture.stop();
+    if (PROFILING_ENABLED && StageProfiler::instance().writeCsv(profileCsvPath)) {
+        std::cout << "Latencias por etapa guardadas en " << profileCsvPath << std::endl;
+    }
     std::cout << "Aplicación cerrada limpiamente." << std::endl;
     return 0;
 }
\ No newline at end of file
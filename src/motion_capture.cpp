@@ -1,4 +1,6 @@
 #include "motion_capture.hpp"
+#include "stage_profiler.hpp"
+#include "work_buffer.hpp"
 #include <iostream>
 #include <algorithm> // Para std::sort (opcional, si quieres ordenar contornos)
 
@@ -16,6 +18,7 @@ bool MotionCapture::initializeCamera(int cameraIndex) {
         std::cerr << "ERROR: No se pudo abrir la cámara con índice " << cameraIndex << std::endl;
         return false;
     }
+    resetTracking();
     std::cout << "Cámara inicializada correctamente." << std::endl;
     return true;
 }
@@ -31,99 +34,468 @@ bool MotionCapture::isCameraOpen() const {
     return cap.isOpened();
 }
 
-cv::Mat MotionCapture::getCurrentFrame() {
-    cv::Mat frame;
-    if (cap.isOpened()) {
-        cap >> frame;
-        if (!frame.empty()) {
-             cv::flip(frame, frame, 1); // Espejar horizontalmente
-        }
+bool MotionCapture::readFrame(cv::Mat& frame) {
+    PROFILE_STAGE(CameraRead);
+    // read() reutiliza el buffer de `frame` si ya tiene el tamaño del frame de la cámara.
+    if (!cap.isOpened() || !cap.read(frame) || frame.empty()) {
+        return false;
     }
-    return frame;
+    cv::flip(frame, frame, 1); // Espejar horizontalmente, en el sitio
+    return true;
 }
 
-std::vector<sf::Vector2f> MotionCapture::getBlueObjectPositions() {
-    std::vector<sf::Vector2f> positions;
+bool MotionCapture::captureTick(FrameContext& context) {
+    context.valid = readFrame(context.frame);
+    if (!context.valid) {
+        context.pose.clear();
+        return false;
+    }
+    ++context.tick;
+    detectMarkers(context.frame, context.pose);
+    return true;
+}
+
+DetectedPose MotionCapture::getMarkerPositions() {
     if (!isCameraOpen()) {
-        return positions;
+        return DetectedPose{};
+    }
+    if (!captureTick(lastTick)) {
+        std::cerr << "ERROR: Frame vacío capturado en getMarkerPositions." << std::endl;
+    }
+    return lastTick.pose;
+}
+
+void MotionCapture::resetTracking() {
+    tracks.clear();
+    framesSinceFullScan = 0;
+    sceneScale = 0; // El escaneo incremental también vuelve a empezar desde cero
+}
+
+void MotionCapture::detectMarkers(const cv::Mat& frame, DetectedPose& pose) {
+    PROFILE_STAGE(Detection);
+    pose.clear();
+    frameLabels.release(); // Solo vale para esta detección (ver displayDebugCameraView)
+
+    rangeScratch.clear();
+    for (const auto& color : markerColors) {
+        rangeScratch.push_back(color.range);
+    }
+    if (colorLut.update(rangeScratch) || tracks.size() != markerColors.size()) {
+        resetTracking(); // Cambió la tabla de colores: los tracks anteriores ya no valen
+        tracks.resize(markerColors.size());
+    }
+
+    bool anyActive = false;
+    for (const auto& track : tracks) {
+        anyActive = anyActive || track.active;
+    }
+
+    bool tracked = false;
+    if (roiTrackingEnabled && anyActive && framesSinceFullScan < fullScanInterval) {
+        tracked = trackInWindows(frame);
+    }
+    if (tracked) {
+        ++framesSinceFullScan;
+    } else {
+        fullScan(frame);
+        framesSinceFullScan = 0;
+    }
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        if (tracks[i].active) {
+            pose.set(markerColors[i].joint, tracks[i].position, tracks[i].confidence);
+        }
+    }
+}
+
+void MotionCapture::fullScan(const cv::Mat& frame) {
+    blobScratch.clear();
+    if (changeGateEnabled) {
+        scanChangedTiles(frame, blobScratch);
+    } else {
+        scanRegion(frame, cv::Rect(0, 0, frame.cols, frame.rows), blobScratch);
+        sceneScale = 0;
+    }
+
+    // Para cada color, el objeto más grande de ese color.
+    for (auto& track : tracks) {
+        track.active = false;
+    }
+    for (const auto& blob : blobScratch) {
+        MarkerTrack& track = tracks[blob.colorIndex];
+        if (!track.active || blob.area > track.area) {
+            track.active = true;
+            track.position = blob.center;
+            track.velocity = sf::Vector2f(0.f, 0.f);
+            track.bounds = blob.bounds;
+            track.area = blob.area;
+            track.confidence = blob.confidence;
+        }
+    }
+}
+
+bool MotionCapture::trackInWindows(const cv::Mat& frame) {
+    const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        MarkerTrack& track = tracks[i];
+        if (!track.active) {
+            continue; // Se buscará de nuevo en el próximo escaneo completo
+        }
+        // Ventana: bounding box anterior desplazado por la velocidad estimada, más el margen.
+        cv::Rect window(track.bounds.x + static_cast<int>(track.velocity.x) - roiMargin,
+                        track.bounds.y + static_cast<int>(track.velocity.y) - roiMargin,
+                        track.bounds.width + 2 * roiMargin,
+                        track.bounds.height + 2 * roiMargin);
+        window &= frameRect;
+        if (window.empty()) {
+            return false;
+        }
+
+        blobScratch.clear();
+        scanRegion(frame, window, blobScratch);
+
+        // Se queda con el objeto de su color más cercano a la posición predicha.
+        const sf::Vector2f predicted = track.position + track.velocity;
+        const DetectedBlob* best = nullptr;
+        float bestDistance = 0.f;
+        for (const auto& blob : blobScratch) {
+            if (blob.colorIndex != static_cast<int>(i)) {
+                continue;
+            }
+            sf::Vector2f d = blob.center - predicted;
+            float distance = d.x * d.x + d.y * d.y;
+            if (!best || distance < bestDistance) {
+                best = &blob;
+                bestDistance = distance;
+            }
+        }
+        if (!best) {
+            return false; // Marcador perdido
+        }
+
+        // Si el objeto toca el borde de la ventana (y no el del frame) puede estar cortado:
+        // su centroide no es fiable, así que se prefiere un escaneo completo.
+        const cv::Rect& b = best->bounds;
+        bool touchesLeft = b.x <= window.x && window.x > 0;
+        bool touchesTop = b.y <= window.y && window.y > 0;
+        bool touchesRight = b.x + b.width >= window.x + window.width && window.x + window.width < frame.cols;
+        bool touchesBottom = b.y + b.height >= window.y + window.height && window.y + window.height < frame.rows;
+        if (touchesLeft || touchesTop || touchesRight || touchesBottom) {
+            return false;
+        }
+
+        track.velocity = best->center - track.position;
+        track.position = best->center;
+        track.bounds = best->bounds;
+        track.area = best->area;
+        track.confidence = best->confidence;
+    }
+    return true;
+}
+
+void MotionCapture::scanRegion(const cv::Mat& frame, const cv::Rect& region, std::vector<DetectedBlob>& blobs) {
+    const int scale = std::max(1, pyramidScale);
+    const cv::Mat view = frame(region);
+
+    // Clasificar todos los colores de marcador directamente desde BGR (sin imagen HSV intermedia).
+    // En modo piramidal solo se clasifica un pixel de cada scale x scale.
+    {
+        PROFILE_STAGE(ColorClassify);
+        // La máscara es una vista sobre un buffer que solo crece: las ventanas de seguimiento
+        // cambian de tamaño cada frame y no deben provocar reservas.
+        colorMask = workBuffer(colorMaskStorage, cv::Size((view.cols + scale - 1) / scale, (view.rows + scale - 1) / scale), CV_8UC1);
+        colorLut.classifyStrided(view, colorMask, scale);
+        // Solo un escaneo del frame completo a resolución completa deja etiquetas de todo el frame.
+        if (scale == 1 && region.size() == frame.size()) {
+            frameLabels = colorMask;
+        } else {
+            frameLabels.release();
+        }
     }
 
-    cv::Mat frame = getCurrentFrame();
-    if (frame.empty()) {
-        std::cerr << "ERROR: Frame vacío capturado en getBlueObjectPositions." << std::endl;
-        return positions;
+    // Operaciones morfológicas para limpiar la máscara. Se hacen sobre el primer plano de
+    // todos los colores a la vez, empaquetado a 1 bit por pixel; las etiquetas originales
+    // solo se usan después para decidir el color de cada objeto.
+    // En el nivel submuestreado el núcleo de 5x5 equivale a menos de 3x3, así que se usa 3x3.
+    {
+        PROFILE_STAGE(Morphology);
+        const int kernelSize = scale == 1 ? 5 : 3; // Elipse, como getStructuringElement(MORPH_ELLIPSE)
+        foregroundMask.fromLabels(colorMask);
+        // Erosión para eliminar pequeños puntos de ruido
+        morphology.erode(foregroundMask, kernelSize, erodeIterations);
+        // Dilatación para cerrar huecos y restaurar tamaño de objetos
+        morphology.dilate(foregroundMask, kernelSize, dilateIterations);
     }
 
-    // Convertir frame a HSV
-    cv::cvtColor(frame, hsvFrame, cv::COLOR_BGR2HSV);
+    // Componentes conexas con área, centroide y color mayoritario en una sola pasada sobre
+    // la máscara empaquetada (coordenadas de la máscara; se pasan al frame completo abajo)
+    {
+        PROFILE_STAGE(BlobExtraction);
+        blobExtractor.extract(foregroundMask, cv::Point(), colorMask, static_cast<int>(markerColors.size()));
+    }
 
-    // Crear máscara para el color azul
-    cv::Scalar lowerBlue = cv::Scalar(blue_H_min, blue_S_min, blue_V_min);
-    cv::Scalar upperBlue = cv::Scalar(blue_H_max, blue_S_max, blue_V_max);
-    cv::inRange(hsvFrame, lowerBlue, upperBlue, colorMask);
+    for (const auto& blob : blobExtractor.blobs()) {
+        DetectedBlob detected;
+        if (toDetectedBlob(frame, blob, region.tl(), detected)) {
+            blobs.push_back(detected);
+        }
+    }
+}
+
+bool MotionCapture::toDetectedBlob(const cv::Mat& frame, const Blob& blob, cv::Point origin, DetectedBlob& out) {
+    const int scale = std::max(1, pyramidScale);
+    double area = blob.contourArea() * static_cast<double>(scale) * scale;
+    if (area <= minContourArea || blob.label <= 0) { // Filtrar por área mínima
+        return false;
+    }
+    cv::Rect coarse = blob.bounds();
+    cv::Rect bounds(origin.x + coarse.x * scale, origin.y + coarse.y * scale,
+                    coarse.width * scale, coarse.height * scale);
+    // El pixel grueso (x, y) es el pixel muestreado (x * scale, y * scale) de la región.
+    sf::Vector2f center(static_cast<float>(origin.x) + blob.centerX() * static_cast<float>(scale),
+                        static_cast<float>(origin.y) + blob.centerY() * static_cast<float>(scale));
+    if (scale > 1) {
+        // Ventana de refinamiento: el bounding box con un bloque de margen por lado, que
+        // cubre los pixels del borde que cayeron entre dos muestras.
+        cv::Rect window(bounds.x - scale, bounds.y - scale, bounds.width + 2 * scale, bounds.height + 2 * scale);
+        center = refineCentroid(frame, window & cv::Rect(0, 0, frame.cols, frame.rows), blob.label, center);
+    }
+    out = {center, bounds, area, blob.label - 1,
+           static_cast<float>(blob.labelPixels) / static_cast<float>(blob.votedPixels)};
+    return true;
+}
 
-    // Operaciones morfológicas para limpiar la máscara
-    // Erosión para eliminar pequeños puntos de ruido
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-    cv::erode(colorMask, colorMask, kernel, cv::Point(-1,-1), 1); // 1 iteración de erosión
-    // Dilatación para cerrar huecos y restaurar tamaño de objetos
-    cv::dilate(colorMask, colorMask, kernel, cv::Point(-1,-1), 2); // 2 iteraciones de dilatación
+namespace {
+cv::Rect expandRect(const cv::Rect& rect, int margin) {
+    return cv::Rect(rect.x - margin, rect.y - margin, rect.width + 2 * margin, rect.height + 2 * margin);
+}
 
+// true si los rectángulos se solapan o son vecinos (8-conectividad).
+bool rectsTouch(const cv::Rect& a, const cv::Rect& b) {
+    return (expandRect(a, 1) & b).area() > 0;
+}
+}
 
-    // Encontrar contornos
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(colorMask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+void MotionCapture::scanChangedTiles(const cv::Mat& frame, std::vector<DetectedBlob>& blobs) {
+    const int scale = std::max(1, pyramidScale);
+    const cv::Size coarseSize((frame.cols + scale - 1) / scale, (frame.rows + scale - 1) / scale);
+    const cv::Rect coarseRect(cv::Point(), coarseSize);
+    const int kernelSize = scale == 1 ? 5 : 3; // Como en scanRegion
+    // Distancia hasta la que un pixel de etiquetas influye en el primer plano limpio
+    // (cada erosión o dilatación la amplía en el radio del núcleo).
+    const int reach = (std::max(0, erodeIterations) + std::max(0, dilateIterations)) * (kernelSize / 2);
+    const int labelCount = static_cast<int>(markerColors.size());
+    auto toCoarse = [scale](const cv::Rect& r) {
+        return cv::Rect(r.x / scale, r.y / scale,
+                        (r.x + r.width + scale - 1) / scale - r.x / scale,
+                        (r.y + r.height + scale - 1) / scale - r.y / scale);
+    };
 
-    // Opcional: Ordenar contornos (ej. de izquierda a derecha, o por área)
-    // std::sort(contours.begin(), contours.end(), [](const std::vector<cv::Point>& c1, const std::vector<cv::Point>& c2){
-    //     cv::Moments m1 = cv::moments(c1);
-    //     cv::Moments m2 = cv::moments(c2);
-    //     return m1.m10 / m1.m00 < m2.m10 / m2.m00; // Ordenar por coordenada X del centroide
-    // });
+    // Tiles que hay que rehacer: los que cambiaron, más las ventanas de los marcadores
+    // seguidos (aunque su cambio no supere el umbral).
+    changeGate.tileSize = std::max(scale, changeTileSize / scale * scale);
+    changeGate.threshold = changeThreshold;
+    if (sceneScale != scale || sceneLabels.size() != coarseSize ||
+        sceneErode != erodeIterations || sceneDilate != dilateIterations) {
+        changeGate.reset();
+        sceneBlobs.clear();
+        sceneLabels.create(coarseSize, CV_8UC1);
+        sceneForeground.resize(coarseSize.height, coarseSize.width);
+    }
+    changeGate.detect(frame);
+    for (const auto& track : tracks) {
+        if (track.active) {
+            changeGate.markDirty(cv::Rect(track.bounds.x + static_cast<int>(track.velocity.x) - roiMargin,
+                                          track.bounds.y + static_cast<int>(track.velocity.y) - roiMargin,
+                                          track.bounds.width + 2 * roiMargin, track.bounds.height + 2 * roiMargin));
+        }
+    }
+    if (changeGate.dirtyFraction() > changeMaxDirtyFraction) {
+        changeGate.markDirty(cv::Rect(0, 0, frame.cols, frame.rows)); // Sale más barato rehacer todo
+    }
 
+    // Grupos de tiles cambiados vecinos -> un rectángulo por grupo (en el nivel de detección).
+    const int gridCols = changeGate.gridCols();
+    const int gridRows = changeGate.gridRows();
+    dirtyRects.clear();
+    tileVisited.assign(static_cast<std::size_t>(gridCols) * gridRows, 0);
+    for (int start = 0; start < gridCols * gridRows; ++start) {
+        if (tileVisited[start] || !changeGate.isDirty(start % gridCols, start / gridCols)) {
+            continue;
+        }
+        cv::Rect group = changeGate.tileRect(start % gridCols, start / gridCols);
+        tileVisited[start] = 1;
+        tileStack.assign(1, start);
+        while (!tileStack.empty()) {
+            const int tile = tileStack.back();
+            tileStack.pop_back();
+            const int tx = tile % gridCols, ty = tile / gridCols;
+            group |= changeGate.tileRect(tx, ty);
+            for (int ny = std::max(0, ty - 1); ny <= std::min(gridRows - 1, ty + 1); ++ny) {
+                for (int nx = std::max(0, tx - 1); nx <= std::min(gridCols - 1, tx + 1); ++nx) {
+                    const int neighbor = ny * gridCols + nx;
+                    if (!tileVisited[neighbor] && changeGate.isDirty(nx, ny)) {
+                        tileVisited[neighbor] = 1;
+                        tileStack.push_back(neighbor);
+                    }
+                }
+            }
+        }
+        dirtyRects.push_back(toCoarse(group));
+    }
 
-    for (const auto& contour : contours) {
-        double area = cv::contourArea(contour);
-        if (area > minContourArea) { // Filtrar por área mínima
-            cv::Moments m = cv::moments(contour);
-            if (m.m00 > 0) { // Evitar división por cero
-                cv::Point2f center(static_cast<float>(m.m10 / m.m00), static_cast<float>(m.m01 / m.m00));
-                positions.push_back(sf::Vector2f(center.x, center.y));
+    {
+        PROFILE_STAGE(ColorClassify);
+        for (int ty = 0; ty < gridRows; ++ty) {
+            for (int tx = 0; tx < gridCols; ++tx) {
+                if (changeGate.isDirty(tx, ty)) {
+                    const cv::Rect tile = changeGate.tileRect(tx, ty);
+                    cv::Mat labels = sceneLabels(toCoarse(tile));
+                    colorLut.classifyStrided(frame(tile), labels, scale);
+                }
             }
         }
     }
-    return positions;
+
+    // Morfología de cada grupo con un margen de `reach` a cada lado: se escribe de vuelta la
+    // parte a la que pudo llegar el cambio, y el margen exterior solo da contexto (cerca del
+    // borde de la región de trabajo el resultado no es el del frame completo).
+    {
+        PROFILE_STAGE(Morphology);
+        extractRects.clear();
+        for (const cv::Rect& dirtyRect : dirtyRects) {
+            const cv::Rect write = expandRect(dirtyRect, reach) & coarseRect;
+            const cv::Rect work = expandRect(write, reach) & coarseRect;
+            regionMask.fromLabels(sceneLabels(work));
+            morphology.erode(regionMask, kernelSize, erodeIterations);
+            morphology.dilate(regionMask, kernelSize, dilateIterations);
+            sceneForeground.copyRegion(regionMask, cv::Rect(write.tl() - work.tl(), write.size()), write.tl());
+            extractRects.push_back(write);
+        }
+    }
+
+    // Componentes conexas: cada región se amplía hasta contener completas las componentes
+    // anteriores que toca (y se une con las regiones que toca), esas componentes se descartan
+    // y se vuelven a extraer. Las demás no cambiaron y se reutilizan.
+    {
+        PROFILE_STAGE(BlobExtraction);
+        bool grown = true;
+        while (grown) {
+            grown = false;
+            for (cv::Rect& region : extractRects) {
+                for (const SceneBlob& scene : sceneBlobs) {
+                    if (rectsTouch(region, scene.bounds) && (region | scene.bounds) != region) {
+                        region |= scene.bounds;
+                        grown = true;
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < extractRects.size(); ++i) {
+                for (std::size_t j = i + 1; j < extractRects.size();) {
+                    if (rectsTouch(extractRects[i], extractRects[j])) {
+                        extractRects[i] |= extractRects[j];
+                        extractRects.erase(extractRects.begin() + static_cast<std::ptrdiff_t>(j));
+                        grown = true;
+                    } else {
+                        ++j;
+                    }
+                }
+            }
+        }
+        sceneBlobs.erase(std::remove_if(sceneBlobs.begin(), sceneBlobs.end(), [this](const SceneBlob& scene) {
+            for (const cv::Rect& region : extractRects) {
+                if (rectsTouch(region, scene.bounds)) return true;
+            }
+            return false;
+        }), sceneBlobs.end());
+
+        for (const cv::Rect& region : extractRects) {
+            regionMask.resize(region.height, region.width);
+            regionMask.copyRegion(sceneForeground, region, cv::Point());
+            blobExtractor.extract(regionMask, region.tl(), sceneLabels(region), labelCount);
+            for (const Blob& blob : blobExtractor.blobs()) {
+                SceneBlob scene{blob.bounds(), false, {}};
+                scene.reported = toDetectedBlob(frame, blob, cv::Point(), scene.detected);
+                sceneBlobs.push_back(scene);
+            }
+        }
+    }
+
+    sceneScale = scale;
+    if (scale == 1) {
+        frameLabels = sceneLabels; // Tiles reclasificados + los que no cambiaron
+    }
+    sceneErode = erodeIterations;
+    sceneDilate = dilateIterations;
+    changeGate.commit(frame);
+    for (const SceneBlob& scene : sceneBlobs) {
+        if (scene.reported) {
+            blobs.push_back(scene.detected);
+        }
+    }
 }
 
-void MotionCapture::displayDebugCameraView(bool showMask) {
-    if (!isCameraOpen()) return;
+sf::Vector2f MotionCapture::refineCentroid(const cv::Mat& frame, const cv::Rect& window, int label, sf::Vector2f fallback) {
+    PROFILE_STAGE(CentroidRefine);
+    if (window.empty()) {
+        return fallback;
+    }
+    refineMask = workBuffer(refineMaskStorage, window.size(), CV_8UC1);
+    colorLut.classify(frame(window), refineMask);
+    double sumX = 0.0, sumY = 0.0;
+    std::uint64_t count = 0;
+    for (int y = 0; y < refineMask.rows; ++y) {
+        const std::uint8_t* row = refineMask.ptr<std::uint8_t>(y);
+        std::uint64_t rowCount = 0;
+        double rowSumX = 0.0;
+        for (int x = 0; x < refineMask.cols; ++x) {
+            if (row[x] == label) {
+                ++rowCount;
+                rowSumX += x;
+            }
+        }
+        count += rowCount;
+        sumX += rowSumX;
+        sumY += static_cast<double>(rowCount) * y;
+    }
+    if (count == 0) {
+        return fallback;
+    }
+    return sf::Vector2f(static_cast<float>(window.x + sumX / static_cast<double>(count)),
+                        static_cast<float>(window.y + sumY / static_cast<double>(count)));
+}
 
-    cv::Mat frame = getCurrentFrame(); // Obtiene el frame ya espejado
-    if (frame.empty()) return;
+void MotionCapture::displayDebugCameraView(const FrameContext& context, bool showMask) {
+    if (!context.valid) return;
+    const cv::Mat& frame = context.frame; // Frame ya espejado del tick
 
     if (showMask) {
-        // Asegurarse de que colorMask esté actualizada (se actualiza en getBlueObjectPositions)
-        // Para esta demo, si getBlueObjectPositions no se llama en el mismo ciclo,
-        // la máscara podría no estar lista o ser de un frame anterior.
-        // Sería mejor recalcularla aquí si es necesario o asegurar el flujo.
-        // Por simplicidad, asumimos que se llamó getBlueObjectPositions antes en el bucle principal.
-        if (!colorMask.empty()) {
-            cv::Mat maskedFrame;
-            cv::bitwise_and(frame, frame, maskedFrame, colorMask);
-            // cv::imshow("OpenCV Debug View (Masked)", maskedFrame);
-            // cv::imshow("Color Mask", colorMask); // Para ver solo la máscara binaria
-        } else {
-            //  cv::imshow("OpenCV Debug View (Original)", frame); // Mostrar original si no hay máscara
+        // Máscara de clasificación (antes de la limpieza morfológica). Si la última detección
+        // dejó etiquetas de todo el frame a resolución completa (colorMask de un escaneo
+        // completo, o sceneLabels con el escaneo incremental) se reutilizan; si no (ventanas
+        // de seguimiento o pirámide), se clasifica el frame completo en un buffer propio.
+        // colorMask no sirve por sí sola: con el escaneo incremental no se escribe y se
+        // quedaría la de un frame anterior.
+        cv::Mat mask = frameLabels;
+        if (mask.size() != frame.size()) {
+            mask = workBuffer(debugMaskStorage, frame.size(), CV_8UC1);
+            colorLut.classify(frame, mask);
         }
+        debugFrame.create(frame.size(), frame.type());
+        debugFrame.setTo(cv::Scalar::all(0));
+        frame.copyTo(debugFrame, mask);
+        // cv::imshow("OpenCV Debug View (Masked)", debugFrame);
+        // cv::imshow("Color Mask", mask); // Para ver solo la máscara de etiquetas
     } else {
-        // Dibujar círculos en los puntos detectados si no se muestra la máscara
-        // (requeriría llamar a getBlueObjectPositions y dibujar sobre 'frame')
-        // O simplemente mostrar el frame original
-        std::vector<sf::Vector2f> bluePoints = getBlueObjectPositions(); // Llama para actualizar y obtener puntos
-        cv::Mat displayFrame = frame.clone(); // Clonar para no modificar el frame original que podría usarse en otro lado
-        for(const auto& point : bluePoints){
-            cv::circle(displayFrame, cv::Point(static_cast<int>(point.x), static_cast<int>(point.y)), 5, cv::Scalar(0,255,0), 2);
-        }
-        // cv::imshow("OpenCV Debug View (Original with Detections)", displayFrame);
+        // Dibujar círculos en los puntos detectados en este mismo frame
+        frame.copyTo(debugFrame); // Copia en un buffer persistente para no modificar el frame del tick
+        for (size_t i = 0; i < kJointCount; ++i) {
+            if (context.pose.confidence[i] > 0.f) {
+                const sf::Vector2f& point = context.pose.positions[i];
+                cv::circle(debugFrame, cv::Point(static_cast<int>(point.x), static_cast<int>(point.y)), 5, cv::Scalar(0,255,0), 2);
+            }
+        }
+        // cv::imshow("OpenCV Debug View (Original with Detections)", debugFrame);
     }
 }
@@ -0,0 +1,197 @@
+#include "multi_source_capture.hpp"
+#include <iostream>
+
+namespace {
+// Espera de los hilos de lectura cuando todavía no pueden avanzar.
+constexpr auto kIdleWait = std::chrono::microseconds(500);
+}
+
+MultiSourceCapture::MultiSourceCapture(unsigned threadCount) : pool(threadCount) {}
+
+MultiSourceCapture::~MultiSourceCapture() {
+    stop();
+}
+
+std::size_t MultiSourceCapture::addSource(const CaptureSourceConfig& config) {
+    auto source = std::make_unique<Source>();
+    source->config = config;
+    source->index = sources.size();
+    sources.push_back(std::move(source));
+    return sources.size() - 1;
+}
+
+bool MultiSourceCapture::start() {
+    if (running) {
+        return true;
+    }
+    for (auto& source : sources) {
+        const CaptureSourceConfig& config = source->config;
+        bool opened = config.path.empty() ? source->capture.open(config.cameraIndex) : source->capture.open(config.path);
+        if (!opened || !source->capture.isOpened()) {
+            if (config.path.empty()) {
+                std::cerr << "ERROR: No se pudo abrir la cámara con índice " << config.cameraIndex << std::endl;
+            } else {
+                std::cerr << "ERROR: No se pudo abrir el video " << config.path << std::endl;
+            }
+            for (auto& other : sources) {
+                other->capture.release();
+            }
+            return false;
+        }
+        source->detector.pyramidScale = config.pyramidScale;
+        source->detector.resetTracking();
+        source->readFinished.store(false, std::memory_order_relaxed);
+    }
+
+    // Los hilos del grupo ya reparten el trabajo: evitar que OpenCV lance los suyos encima.
+    if (pool.threadCount() > 1) {
+        cv::setNumThreads(1);
+    }
+
+    running = true;
+    reading.store(true, std::memory_order_relaxed);
+    for (auto& source : sources) {
+        source->readThread = std::thread(&MultiSourceCapture::readLoop, this, std::ref(*source));
+    }
+    std::cout << "Captura multi-fuente iniciada: " << sources.size() << " fuentes, "
+              << pool.threadCount() << " hilos de detección." << std::endl;
+    return true;
+}
+
+void MultiSourceCapture::stop() {
+    if (!running) {
+        return;
+    }
+    reading.store(false, std::memory_order_relaxed);
+    for (auto& source : sources) {
+        if (source->readThread.joinable()) source->readThread.join();
+    }
+    // Sin lectura no se encolan tareas nuevas; las que quedan terminan con el último frame.
+    for (auto& source : sources) {
+        while (source->jobScheduled.load()) {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+        source->capture.release();
+    }
+    running = false;
+
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        SourceStats s = stats(i);
+        std::cout << "Fuente " << i << " detenida. Frames capturados: " << s.framesCaptured
+                  << ", descartados: " << s.framesDropped
+                  << ", poses detectadas: " << s.posesDetected
+                  << ", descartadas: " << s.posesDropped << std::endl;
+    }
+    WorkStealingPool::Stats p = pool.stats();
+    std::cout << "Tareas de detección: " << p.executed << " (" << p.stolen << " robadas)." << std::endl;
+}
+
+void MultiSourceCapture::waitUntilDrained() {
+    for (const auto& source : sources) {
+        if (source->config.path.empty() || (source->config.realtime && source->config.loop)) {
+            std::cerr << "ERROR: waitUntilDrained necesita fuentes de archivo sin loop." << std::endl;
+            return;
+        }
+    }
+    for (auto& source : sources) {
+        while (!source->readFinished.load() || source->frameSlot.hasFresh() || source->jobScheduled.load()) {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+    }
+}
+
+void MultiSourceCapture::readLoop(Source& source) {
+    const CaptureSourceConfig& config = source.config;
+    const bool isFile = !config.path.empty();
+    const bool paced = isFile && config.realtime;
+    double reportedFps = isFile ? source.capture.get(cv::CAP_PROP_FPS) : 0.0;
+    const auto framePeriod = std::chrono::duration<double>(1.0 / (reportedFps > 0.0 ? reportedFps : 30.0));
+
+    std::uint64_t nextFrameId = 0;
+    std::uint64_t framesSinceRewind = 0;
+    PipelineClock::time_point rewindTime = PipelineClock::now();
+    while (reading.load(std::memory_order_relaxed)) {
+        // Archivo sin tiempo real: no se descarta ningún frame, se espera a la detección.
+        if (isFile && !config.realtime && source.frameSlot.hasFresh()) {
+            std::this_thread::sleep_for(kIdleWait);
+            continue;
+        }
+        FramePacket& packet = source.frameSlot.writeBuffer();
+        if (!source.capture.read(packet.image) || packet.image.empty()) {
+            if (!isFile) {
+                std::this_thread::sleep_for(kIdleWait);
+                continue;
+            }
+            if (!paced || !config.loop) {
+                break; // Fin del archivo
+            }
+            source.capture.set(cv::CAP_PROP_POS_FRAMES, 0.0);
+            framesSinceRewind = 0;
+            rewindTime = PipelineClock::now();
+            continue;
+        }
+        if (paced) {
+            std::this_thread::sleep_until(rewindTime + std::chrono::duration_cast<PipelineClock::duration>(
+                framePeriod * static_cast<double>(framesSinceRewind)));
+            ++framesSinceRewind;
+        }
+        if (config.mirror) {
+            cv::flip(packet.image, packet.image, 1); // Igual que en el modo en vivo
+        }
+        packet.frameId = nextFrameId++;
+        packet.captureTime = PipelineClock::now();
+        source.frameSlot.publish();
+        scheduleDetection(source);
+    }
+    source.readFinished.store(true);
+}
+
+void MultiSourceCapture::scheduleDetection(Source& source) {
+    // Con la barrera de detectionJob: o la tarea ve el frame nuevo o aquí se ve que terminó.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (source.jobScheduled.exchange(true)) {
+        return;
+    }
+    const std::size_t index = source.index;
+    pool.submit([this, index] { detectionJob(index); });
+}
+
+void MultiSourceCapture::detectionJob(std::size_t index) {
+    Source& source = *sources[index];
+    // Un solo frame por tarea: si llegó otro, la tarea se vuelve a encolar detrás de las de
+    // las demás fuentes en vez de quedarse con el hilo.
+    if (source.frameSlot.consume()) {
+        const FramePacket& frame = source.frameSlot.readBuffer();
+        PosePacket& pose = source.poseSlot.writeBuffer();
+        source.detector.detectMarkers(frame.image, pose.pose);
+        pose.frameId = frame.frameId;
+        pose.captureTime = frame.captureTime;
+        pose.detectTime = PipelineClock::now();
+        if (poseCallback) {
+            poseCallback(index, pose);
+        }
+        source.poseSlot.publish();
+    }
+    source.jobScheduled.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (source.frameSlot.hasFresh()) {
+        scheduleDetection(source);
+    }
+}
+
+const PosePacket* MultiSourceCapture::latestPose(std::size_t source) {
+    if (source >= sources.size() || !sources[source]->poseSlot.consume()) {
+        return nullptr;
+    }
+    return &sources[source]->poseSlot.readBuffer();
+}
+
+MultiSourceCapture::SourceStats MultiSourceCapture::stats(std::size_t source) const {
+    SourceStats s;
+    const Source& src = *sources[source];
+    s.framesCaptured = src.frameSlot.publishedCount();
+    s.framesDropped = src.frameSlot.droppedCount();
+    s.posesDetected = src.poseSlot.publishedCount();
+    s.posesDropped = src.poseSlot.droppedCount();
+    return s;
+}
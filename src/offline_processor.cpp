@@ -0,0 +1,185 @@
+#include "offline_processor.hpp"
+#include "motion_capture.hpp"
+#include "parallel_for.hpp"
+#include "pose_track.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+OfflineProcessor::OfflineProcessor(const OfflineOptions& options) : options(options) {}
+
+bool OfflineProcessor::run() {
+    cv::VideoCapture probe(options.inputPath);
+    if (!probe.isOpened()) {
+        std::cerr << "ERROR: No se pudo abrir el video " << options.inputPath << std::endl;
+        return false;
+    }
+    double reportedFps = probe.get(cv::CAP_PROP_FPS);
+    fps = reportedFps > 0.0 ? reportedFps : 30.0;
+    const double reportedFrames = probe.get(cv::CAP_PROP_FRAME_COUNT);
+
+    ParallelFor workers(options.workers);
+
+    // Tramos de frames consecutivos. Si el contenedor no informa el número de frames,
+    // todo el archivo se procesa como un solo tramo.
+    std::vector<Chunk> chunks;
+    const std::uint64_t frameCount = reportedFrames > 0.0 ? static_cast<std::uint64_t>(reportedFrames) : 0;
+    if (frameCount == 0) {
+        chunks.emplace_back();
+    } else {
+        // Algunos tramos más que hilos, para repartir mejor la carga.
+        std::uint64_t chunkCount = std::max<std::uint64_t>(1, std::min<std::uint64_t>(
+            4ull * workers.threadCount(), frameCount / std::max<std::size_t>(1, options.minChunkFrames)));
+        std::uint64_t chunkLength = (frameCount + chunkCount - 1) / chunkCount;
+        for (std::uint64_t first = 0; first < frameCount; first += chunkLength) {
+            Chunk chunk;
+            chunk.firstFrame = first;
+            chunk.endFrame = std::min(first + chunkLength, frameCount);
+            chunks.push_back(std::move(chunk));
+        }
+        // El último tramo sigue hasta el final real (el número de frames puede ser aproximado).
+        chunks.back().endFrame = 0;
+        // Los tramos solo compensan si el backend busca con precisión; se comprueba una vez, con
+        // el principio del segundo tramo. Si no, todo el archivo va en un solo tramo secuencial:
+        // llegar a cada tramo decodificando desde el principio costaría O(N²).
+        if (chunks.size() > 1) {
+            probe.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(chunks[1].firstFrame));
+            if (static_cast<std::uint64_t>(probe.get(cv::CAP_PROP_POS_FRAMES)) != chunks[1].firstFrame) {
+                std::cout << "El video no permite buscar frames con precisión: se procesa en un solo tramo." << std::endl;
+                chunks.assign(1, Chunk{});
+            }
+        }
+    }
+    probe.release();
+
+    std::cout << "Procesando " << options.inputPath << " (" << frameCount << " frames, " << fps
+              << " fps) en " << chunks.size() << " tramos con " << workers.threadCount() << " hilos." << std::endl;
+
+    // Cada hilo ya procesa un tramo: evitar que OpenCV lance sus propios hilos encima.
+    if (workers.threadCount() > 1) {
+        cv::setNumThreads(1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    workers.run(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            processChunk(chunks[i]);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Unir en orden de frame.
+    frames.clear();
+    for (auto& chunk : chunks) {
+        if (!chunk.ok) {
+            std::cerr << "ERROR: No se pudo abrir el video para el tramo que empieza en el frame " << chunk.firstFrame << std::endl;
+            return false;
+        }
+        frames.insert(frames.end(), chunk.results.begin(), chunk.results.end());
+    }
+
+    std::cout << frames.size() << " frames procesados en " << seconds << " s ("
+              << (seconds > 0.0 ? static_cast<double>(frames.size()) / seconds : 0.0) << " fps)." << std::endl;
+
+    const std::string trackExtension = ".ptrk";
+    const std::string& out = options.outputPath;
+    bool isTrack = out.size() >= trackExtension.size() &&
+                   out.compare(out.size() - trackExtension.size(), trackExtension.size(), trackExtension) == 0;
+    return isTrack ? writePoseTrack() : writeCsv();
+}
+
+void OfflineProcessor::processChunk(Chunk& chunk) const {
+    cv::VideoCapture cap(options.inputPath);
+    if (!cap.isOpened()) {
+        chunk.ok = false;
+        return;
+    }
+
+    // OpenCV no expone la posición de los keyframes; al buscar un frame, el backend decodifica
+    // desde el keyframe anterior, así que el tramo empieza exactamente en firstFrame.
+    std::uint64_t frameIndex = 0;
+    if (chunk.firstFrame > 0) {
+        cap.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(chunk.firstFrame));
+        frameIndex = static_cast<std::uint64_t>(cap.get(cv::CAP_PROP_POS_FRAMES));
+        // Si la búsqueda se quedó corta (típico cuando el contenedor sobrestima el número de
+        // frames y el tramo empieza más allá del final real) se avanza leyendo desde ahí; si se
+        // pasó, desde el principio.
+        if (frameIndex > chunk.firstFrame) {
+            cap.set(cv::CAP_PROP_POS_FRAMES, 0.0);
+            frameIndex = 0;
+        }
+        while (frameIndex < chunk.firstFrame && cap.grab()) {
+            ++frameIndex;
+        }
+        if (frameIndex < chunk.firstFrame) {
+            return; // El archivo termina antes del tramo: queda vacío, no es un error
+        }
+    }
+
+    MotionCapture detector; // Cada tramo empieza con un escaneo completo
+    detector.pyramidScale = options.pyramidScale;
+    cv::Mat frame;
+    if (chunk.endFrame > chunk.firstFrame) {
+        chunk.results.reserve(static_cast<std::size_t>(chunk.endFrame - chunk.firstFrame));
+    }
+    while ((chunk.endFrame == 0 || frameIndex < chunk.endFrame) && cap.read(frame) && !frame.empty()) {
+        if (options.mirror) {
+            cv::flip(frame, frame, 1); // Igual que en el modo en vivo
+        }
+        OfflineFrameResult result;
+        result.frameIndex = frameIndex;
+        result.timestampMs = 1000.0 * static_cast<double>(frameIndex) / fps;
+        detector.detectMarkers(frame, result.pose);
+        chunk.results.push_back(result);
+        ++frameIndex;
+    }
+}
+
+bool OfflineProcessor::writeCsv() const {
+    std::ofstream out(options.outputPath);
+    if (!out) {
+        std::cerr << "ERROR: No se pudo escribir " << options.outputPath << std::endl;
+        return false;
+    }
+
+    out << "frame,time_ms";
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        const char* name = jointName(static_cast<JointID>(j));
+        out << ',' << name << "_x," << name << "_y," << name << "_conf";
+    }
+    out << '\n';
+
+    for (const auto& result : frames) {
+        out << result.frameIndex << ',' << result.timestampMs;
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            if (result.pose.confidence[j] > 0.f) {
+                out << ',' << result.pose.positions[j].x << ',' << result.pose.positions[j].y
+                    << ',' << result.pose.confidence[j];
+            } else {
+                out << ",,,0"; // Articulación no detectada en este frame
+            }
+        }
+        out << '\n';
+    }
+
+    std::cout << "Posiciones escritas en " << options.outputPath << std::endl;
+    return static_cast<bool>(out);
+}
+
+bool OfflineProcessor::writePoseTrack() const {
+    PoseTrackWriter writer;
+    if (!writer.open(options.outputPath, fps)) {
+        return false;
+    }
+    for (const auto& result : frames) {
+        if (!writer.append(result.pose, static_cast<std::int64_t>(result.timestampMs * 1000.0))) {
+            std::cerr << "ERROR: No se pudo escribir " << options.outputPath << std::endl;
+            return false;
+        }
+    }
+    writer.close();
+    std::cout << "Pista de pose escrita en " << options.outputPath << std::endl;
+    return true;
+}
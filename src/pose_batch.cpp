@@ -0,0 +1,131 @@
+#include "pose_batch.hpp"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define POSE_BATCH_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define POSE_BATCH_NEON 1
+#endif
+
+namespace {
+
+constexpr std::size_t kSimdWidth = 8; // Relleno de stride (cubre SSE, NEON y AVX)
+constexpr std::size_t kFiguresPerTask = 64;
+
+inline std::size_t roundUp(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// values[i] = offsets[i] + scales[i] * values[i], para i en [begin, end)
+void scaleAndOffset(float* values, const float* offsets, const float* scales, std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+#if defined(POSE_BATCH_SSE2)
+    for (; i + 4 <= end; i += 4) {
+        __m128 v = _mm_loadu_ps(values + i);
+        v = _mm_add_ps(_mm_loadu_ps(offsets + i), _mm_mul_ps(_mm_loadu_ps(scales + i), v));
+        _mm_storeu_ps(values + i, v);
+    }
+#elif defined(POSE_BATCH_NEON)
+    for (; i + 4 <= end; i += 4) {
+        float32x4_t v = vmlaq_f32(vld1q_f32(offsets + i), vld1q_f32(scales + i), vld1q_f32(values + i));
+        vst1q_f32(values + i, v);
+    }
+#endif
+    for (; i < end; ++i) {
+        values[i] = offsets[i] + scales[i] * values[i];
+    }
+}
+
+} // namespace
+
+void PoseBatch::reserve(std::size_t count) {
+    if (roundUp(count, kSimdWidth) > stride) {
+        resizeStorage(roundUp(count, kSimdWidth));
+    }
+    offsetX.reserve(count);
+    offsetY.reserve(count);
+    scales.reserve(count);
+    phases.reserve(count);
+}
+
+void PoseBatch::clear() {
+    figureCount = 0;
+    offsetX.clear();
+    offsetY.clear();
+    scales.clear();
+    phases.clear();
+    vertices.resize(0);
+}
+
+std::size_t PoseBatch::addFigure(sf::Vector2f offset, float scale, std::uint32_t phase) {
+    if (figureCount + 1 > stride) {
+        resizeStorage(std::max(roundUp(figureCount + 1, kSimdWidth), 2 * stride));
+    }
+    offsetX.push_back(offset.x);
+    offsetY.push_back(offset.y);
+    scales.push_back(scale);
+    phases.push_back(phase % kHistoryLength);
+    vertices.resize((figureCount + 1) * figure_geometry::kVerticesPerFigure);
+    return figureCount++;
+}
+
+void PoseBatch::resizeStorage(std::size_t newStride) {
+    std::vector<float> newXs(kJointCount * newStride, 0.f);
+    std::vector<float> newYs(kJointCount * newStride, 0.f);
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        std::copy_n(xs.begin() + j * stride, figureCount, newXs.begin() + j * newStride);
+        std::copy_n(ys.begin() + j * stride, figureCount, newYs.begin() + j * newStride);
+    }
+    xs.swap(newXs);
+    ys.swap(newYs);
+    stride = newStride;
+}
+
+void PoseBatch::pushSourcePose(const std::array<sf::Vector2f, kJointCount>& joints, JointID anchor) {
+    historyHead = (historyHead + 1) % kHistoryLength;
+    const sf::Vector2f origin = joints[jointIndex(anchor)];
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        historyX[historyHead][j] = joints[j].x - origin.x;
+        historyY[historyHead][j] = joints[j].y - origin.y;
+    }
+}
+
+void PoseBatch::update(ParallelFor& workers) {
+    workers.run(figureCount, kFiguresPerTask, [this](std::size_t begin, std::size_t end) {
+        retargetRange(begin, end);
+        emitRange(begin, end);
+    });
+}
+
+void PoseBatch::retargetRange(std::size_t begin, std::size_t end) {
+    // 1) Copiar la pose fuente (con el desfase de cada figura) al layout SoA.
+    for (std::size_t i = begin; i < end; ++i) {
+        const std::size_t slot = (historyHead + kHistoryLength - phases[i]) % kHistoryLength;
+        const float* srcX = historyX[slot].data();
+        const float* srcY = historyY[slot].data();
+        for (std::size_t j = 0; j < kJointCount; ++j) {
+            xs[j * stride + i] = srcX[j];
+            ys[j * stride + i] = srcY[j];
+        }
+    }
+    // 2) Escala + offset por articulación, vectorizado sobre las figuras.
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        scaleAndOffset(xs.data() + j * stride, offsetX.data(), scales.data(), begin, end);
+        scaleAndOffset(ys.data() + j * stride, offsetY.data(), scales.data(), begin, end);
+    }
+}
+
+void PoseBatch::emitRange(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        figure_geometry::writeFigure(xs.data() + i, ys.data() + i, stride,
+                                     &vertices[i * figure_geometry::kVerticesPerFigure], scales[i]);
+    }
+}
+
+void PoseBatch::draw(sf::RenderTarget& target) const {
+    if (figureCount > 0) {
+        target.draw(vertices);
+    }
+}
@@ -0,0 +1,13 @@
+#include "pose_detector.hpp"
+#include "motion_capture.hpp"
+#include "silhouette_detector.hpp"
+
+std::unique_ptr<PoseDetector> makePoseDetector(const std::string& name) {
+    if (name == "color") {
+        return std::make_unique<MotionCapture>();
+    }
+    if (name == "silhouette") {
+        return std::make_unique<SilhouetteDetector>();
+    }
+    return nullptr;
+}
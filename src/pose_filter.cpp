@@ -0,0 +1,87 @@
+#include "pose_filter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+float seconds(PoseFilter::Clock::duration d) {
+    return std::chrono::duration<float>(d).count();
+}
+
+float length(sf::Vector2f v) {
+    return std::sqrt(v.x * v.x + v.y * v.y);
+}
+}
+
+void PoseFilter::reset() {
+    joints = {};
+    rejected = 0;
+}
+
+void PoseFilter::addSample(const DetectedPose& pose, Clock::time_point captureTime) {
+    for (std::size_t i = 0; i < kJointCount; ++i) {
+        if (pose.confidence[i] <= 0.f) {
+            continue;
+        }
+        JointState& joint = joints[i];
+        const sf::Vector2f measured = pose.positions[i];
+
+        float dt = seconds(captureTime - joint.lastTime);
+        if (!joint.valid || dt <= 0.f || dt > staleSeconds) {
+            // Primera muestra, muestra fuera de orden o articulación perdida mucho tiempo: reiniciar.
+            joint.valid = true;
+            joint.position = joint.previousPosition = measured;
+            joint.velocity = sf::Vector2f(0.f, 0.f);
+            joint.lastTime = joint.previousTime = captureTime;
+            joint.confidence = pose.confidence[i];
+            joint.consecutiveOutliers = 0;
+            continue;
+        }
+
+        const sf::Vector2f predicted = joint.position + joint.velocity * dt;
+        const sf::Vector2f residual = measured - predicted;
+        const float gate = outlierDistance + outlierSpeedFactor * length(joint.velocity * dt);
+        if (length(residual) > gate && joint.consecutiveOutliers < maxConsecutiveOutliers) {
+            ++joint.consecutiveOutliers;
+            ++rejected;
+            continue; // Centroide atípico: se sigue con la predicción
+        }
+
+        joint.previousPosition = joint.position;
+        joint.previousTime = joint.lastTime;
+        if (joint.consecutiveOutliers >= maxConsecutiveOutliers && length(residual) > gate) {
+            // El salto se confirmó en varios frames: el marcador realmente está ahí.
+            joint.position = measured;
+            joint.velocity = sf::Vector2f(0.f, 0.f);
+        } else {
+            joint.position = predicted + residual * alpha;
+            joint.velocity += residual * (beta / dt);
+        }
+        joint.lastTime = captureTime;
+        joint.confidence = pose.confidence[i];
+        joint.consecutiveOutliers = 0;
+    }
+}
+
+void PoseFilter::sample(Clock::time_point presentTime, DetectedPose& out) const {
+    out.clear();
+    const Clock::time_point target = presentTime - std::chrono::duration_cast<Clock::duration>(
+                                                       std::chrono::duration<float>(renderDelaySeconds));
+    for (std::size_t i = 0; i < kJointCount; ++i) {
+        const JointState& joint = joints[i];
+        if (!joint.valid || seconds(presentTime - joint.lastTime) > staleSeconds) {
+            continue;
+        }
+        sf::Vector2f position;
+        if (target < joint.lastTime && joint.previousTime < joint.lastTime) {
+            // Interpolación entre las dos últimas muestras filtradas.
+            float span = seconds(joint.lastTime - joint.previousTime);
+            float t = std::clamp(seconds(target - joint.previousTime) / span, 0.f, 1.f);
+            position = joint.previousPosition + (joint.position - joint.previousPosition) * t;
+        } else {
+            float ahead = std::clamp(seconds(target - joint.lastTime), 0.f, maxExtrapolationSeconds);
+            position = joint.position + joint.velocity * ahead;
+        }
+        out.positions[i] = position;
+        out.confidence[i] = joint.confidence;
+    }
+}
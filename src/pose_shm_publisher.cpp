@@ -0,0 +1,87 @@
+#include "pose_shm_publisher.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+
+PoseShmPublisher::~PoseShmPublisher() {
+    close();
+}
+
+bool PoseShmPublisher::open(const std::string& name, std::uint32_t slotCount) {
+    close();
+    if (slotCount == 0) {
+        slotCount = pose_shm::kDefaultSlotCount;
+    }
+    const std::string path = "/" + name;
+    // Siempre un objeto nuevo: redimensionar uno que otros lectores pueden tener mapeado (con
+    // otro número de ranuras) los dejaría leyendo fuera del archivo. Los lectores abiertos
+    // conservan el anillo anterior hasta que vuelven a abrir.
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "ERROR: No se pudo crear el anillo de poses " << path << std::endl;
+        return false;
+    }
+    const std::size_t size = pose_shm::mappingSize(slotCount);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "ERROR: No se pudo dimensionar el anillo de poses " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "ERROR: No se pudo mapear el anillo de poses " << path << std::endl;
+        return false;
+    }
+
+    // Los lectores ignoran el anillo hasta que magic vuelve a ser válido.
+    header = static_cast<pose_shm::Header*>(memory);
+    header->magic.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slots = reinterpret_cast<pose_shm::Slot*>(static_cast<char*>(memory) + sizeof(pose_shm::Header));
+    std::memset(static_cast<void*>(slots), 0, static_cast<std::size_t>(slotCount) * sizeof(pose_shm::Slot));
+    header->version = pose_shm::kVersion;
+    header->jointCount = static_cast<std::uint32_t>(pose_shm::kJointCount);
+    header->slotCount = slotCount;
+    header->slotSize = static_cast<std::uint32_t>(sizeof(pose_shm::Slot));
+    header->published.store(0, std::memory_order_relaxed);
+    header->magic.store(pose_shm::kMagic, std::memory_order_release);
+    mappedSize = size;
+    published = 0;
+    std::cout << "Publicando poses en memoria compartida: " << path << " (" << slotCount << " ranuras)." << std::endl;
+    return true;
+}
+
+void PoseShmPublisher::close() {
+    if (header) {
+        munmap(header, mappedSize);
+        header = nullptr;
+        slots = nullptr;
+        mappedSize = 0;
+    }
+}
+
+void PoseShmPublisher::publish(const DetectedPose& pose, std::chrono::steady_clock::time_point captureTime) {
+    if (!header) {
+        return;
+    }
+    pose_shm::Slot& slot = slots[published % header->slotCount];
+    std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // La secuencia impar, antes que los datos
+
+    slot.frameNumber = published;
+    slot.captureTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(captureTime.time_since_epoch()).count();
+    for (std::size_t j = 0; j < kJointCount; ++j) {
+        slot.x[j] = pose.positions[j].x;
+        slot.y[j] = pose.positions[j].y;
+        slot.confidence[j] = pose.confidence[j];
+    }
+    slot.publishTimeNs = pose_shm::nowNs();
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(++published, std::memory_order_release);
+}
@@ -0,0 +1,104 @@
+#include "pose_shm_reader.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+
+PoseShmReader::~PoseShmReader() {
+    close();
+}
+
+bool PoseShmReader::open(const std::string& name) {
+    close();
+    const std::string path = "/" + name;
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "ERROR: No existe el anillo de poses " << path << " (¿está corriendo el publicador?)" << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(pose_shm::Header)) {
+        std::cerr << "ERROR: El anillo de poses " << path << " no está inicializado." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // El mapeo sigue siendo válido sin el descriptor
+    if (memory == MAP_FAILED) {
+        std::cerr << "ERROR: No se pudo mapear el anillo de poses " << path << std::endl;
+        return false;
+    }
+
+    const auto* mapped = static_cast<const pose_shm::Header*>(memory);
+    if (mapped->magic.load(std::memory_order_acquire) != pose_shm::kMagic ||
+        mapped->version != pose_shm::kVersion || mapped->jointCount != pose_shm::kJointCount ||
+        mapped->slotSize != sizeof(pose_shm::Slot) || mapped->slotCount == 0 ||
+        pose_shm::mappingSize(mapped->slotCount) > size) {
+        std::cerr << "ERROR: El anillo de poses " << path << " tiene un formato distinto." << std::endl;
+        munmap(memory, size);
+        return false;
+    }
+    header = mapped;
+    slots = reinterpret_cast<const pose_shm::Slot*>(static_cast<const char*>(memory) + sizeof(pose_shm::Header));
+    mappedSize = size;
+    ringSlots = mapped->slotCount;
+    return true;
+}
+
+void PoseShmReader::close() {
+    if (header) {
+        munmap(const_cast<pose_shm::Header*>(header), mappedSize);
+        header = nullptr;
+        slots = nullptr;
+        mappedSize = 0;
+        ringSlots = 0;
+    }
+}
+
+std::uint64_t PoseShmReader::oldestAvailable() const {
+    std::uint64_t published = publishedCount();
+    return published > ringSlots ? published - ringSlots : 0;
+}
+
+bool PoseShmReader::read(std::uint64_t frameNumber, pose_shm::Frame& out) const {
+    if (!isOpen()) {
+        return false;
+    }
+    const pose_shm::Slot& slot = slots[frameNumber % ringSlots];
+    std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if ((before & 1u) != 0) {
+        return false;
+    }
+    // Copia en bloque (memcpy) de todo el contenido de la ranura: nunca se lee un campo suelto
+    // mientras el escritor puede estar cambiándolo; la copia se valida después.
+    pose_shm::Frame copy;
+    std::memcpy(&copy.frameNumber, &slot.frameNumber, sizeof(copy.frameNumber));
+    std::memcpy(&copy.captureTimeNs, &slot.captureTimeNs, sizeof(copy.captureTimeNs));
+    std::memcpy(&copy.publishTimeNs, &slot.publishTimeNs, sizeof(copy.publishTimeNs));
+    std::memcpy(copy.x, slot.x, sizeof(copy.x));
+    std::memcpy(copy.y, slot.y, sizeof(copy.y));
+    std::memcpy(copy.confidence, slot.confidence, sizeof(copy.confidence));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != before || copy.frameNumber != frameNumber) {
+        return false;
+    }
+    out = copy;
+    return true;
+}
+
+bool PoseShmReader::readLatest(pose_shm::Frame& out) const {
+    // Si el escritor da la vuelta al anillo mientras se lee, el siguiente intento toma el nuevo último.
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        std::uint64_t published = publishedCount();
+        if (published == 0) {
+            return false;
+        }
+        if (read(published - 1, out)) {
+            return true;
+        }
+    }
+    return false;
+}
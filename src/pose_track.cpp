@@ -0,0 +1,172 @@
+#include "pose_track.hpp"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char kMagic[4] = {'P', 'T', 'R', 'K'};
+constexpr std::uint32_t kVersion = 1;
+}
+
+// --- PoseTrackWriter ---
+
+PoseTrackWriter::~PoseTrackWriter() {
+    close();
+}
+
+bool PoseTrackWriter::open(const std::string& path, double frameRate) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ERROR: No se pudo crear la pista de pose " << path << std::endl;
+        return false;
+    }
+
+    PoseTrackHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.jointCount = static_cast<std::uint32_t>(kJointCount);
+    header.frameStride = static_cast<std::uint32_t>(sizeof(PoseTrackFrame));
+    header.frameRate = frameRate;
+    header.frameCount = 0;
+    framesWritten = 0;
+    return std::fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool PoseTrackWriter::append(const DetectedPose& pose, std::int64_t timestampUs) {
+    if (!file) {
+        return false;
+    }
+    if (framesWritten == 0) {
+        firstTimestampUs = timestampUs;
+    }
+    lastTimestampUs = timestampUs;
+    PoseTrackFrame frame;
+    frame.timestampUs = timestampUs;
+    frame.pose = pose;
+    if (std::fwrite(&frame, sizeof(frame), 1, file) != 1) {
+        return false;
+    }
+    ++framesWritten;
+    return true;
+}
+
+void PoseTrackWriter::close() {
+    if (!file) {
+        return;
+    }
+    // Completar la cabecera con la frecuencia media real y el número final de frames.
+    if (framesWritten > 1 && lastTimestampUs > firstTimestampUs) {
+        double frameRate = static_cast<double>(framesWritten - 1) * 1e6 / static_cast<double>(lastTimestampUs - firstTimestampUs);
+        if (std::fseek(file, offsetof(PoseTrackHeader, frameRate), SEEK_SET) == 0) {
+            std::fwrite(&frameRate, sizeof(frameRate), 1, file);
+        }
+    }
+    if (std::fseek(file, offsetof(PoseTrackHeader, frameCount), SEEK_SET) == 0) {
+        std::fwrite(&framesWritten, sizeof(framesWritten), 1, file);
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+// --- PoseTrackReader ---
+
+PoseTrackReader::~PoseTrackReader() {
+    close();
+}
+
+bool PoseTrackReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ERROR: No se pudo abrir la pista de pose " << path << std::endl;
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(PoseTrackHeader)) {
+        std::cerr << "ERROR: " << path << " no es una pista de pose válida." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* address = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // El mapeo sigue siendo válido sin el descriptor
+    if (address == MAP_FAILED) {
+        std::cerr << "ERROR: No se pudo mapear " << path << std::endl;
+        return false;
+    }
+
+    mapped = address;
+    mappedSize = static_cast<std::size_t>(info.st_size);
+    header = static_cast<const PoseTrackHeader*>(mapped);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->jointCount != kJointCount || header->frameStride < sizeof(PoseTrackFrame) ||
+        header->frameStride % alignof(PoseTrackFrame) != 0 || !std::isfinite(header->frameRate) || header->frameRate <= 0.0) {
+        std::cerr << "ERROR: " << path << " no es compatible con esta versión del formato." << std::endl;
+        close();
+        return false;
+    }
+
+    stride = header->frameStride;
+    firstFrame = static_cast<const std::uint8_t*>(mapped) + sizeof(PoseTrackHeader);
+    // Si la grabación no se cerró bien, frameCount es 0: se usan los frames completos del archivo.
+    std::uint64_t framesInFile = (mappedSize - sizeof(PoseTrackHeader)) / stride;
+    frames = header->frameCount > 0 && header->frameCount <= framesInFile ? header->frameCount : framesInFile;
+    timed = frames > 1 && frame(frames - 1).timestampUs > frame(0).timestampUs;
+    // La reproducción salta (flechas, búsqueda binaria por timestamp) y vuelve atrás al dar la
+    // vuelta: MADV_SEQUENTIAL descartaría las páginas ya leídas, así que se pide acceso aleatorio.
+    ::madvise(mapped, mappedSize, MADV_RANDOM);
+    return true;
+}
+
+void PoseTrackReader::close() {
+    if (mapped) {
+        ::munmap(mapped, mappedSize);
+    }
+    mapped = nullptr;
+    mappedSize = 0;
+    header = nullptr;
+    firstFrame = nullptr;
+    stride = 0;
+    frames = 0;
+    timed = false;
+}
+
+std::uint64_t PoseTrackReader::frameIndexAt(double seconds) const {
+    if (frames == 0 || !(seconds > 0.0)) {
+        return 0;
+    }
+    if (!timed) {
+        double index = seconds * frameRate();
+        return index < static_cast<double>(frames - 1) ? static_cast<std::uint64_t>(index) : frames - 1;
+    }
+    const std::int64_t first = frame(0).timestampUs;
+    const double span = static_cast<double>(frame(frames - 1).timestampUs - first);
+    if (seconds * 1e6 >= span) {
+        return frames - 1;
+    }
+    // Último frame con timestamp <= first + seconds.
+    const std::int64_t target = first + static_cast<std::int64_t>(seconds * 1e6);
+    std::uint64_t low = 0, high = frames - 1;
+    while (low < high) {
+        std::uint64_t middle = low + (high - low + 1) / 2;
+        if (frame(middle).timestampUs <= target) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+double PoseTrackReader::duration() const {
+    if (!timed) {
+        return frames > 0 ? static_cast<double>(frames) / frameRate() : 0.0;
+    }
+    const double span = static_cast<double>(frame(frames - 1).timestampUs - frame(0).timestampUs) * 1e-6;
+    return span + span / static_cast<double>(frames - 1);
+}
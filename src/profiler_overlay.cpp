@@ -0,0 +1,84 @@
+#include "profiler_overlay.hpp"
+#include "stage_profiler.hpp"
+#include <iostream>
+#include <string>
+
+namespace {
+constexpr float kRefreshSeconds = 0.5f;
+constexpr float kConsoleRefreshSeconds = 2.f; // Sin fuente: imprimir con menos frecuencia
+
+// Fuentes monoespaciadas habituales (macOS, Linux, Windows); la primera que abra se usa.
+const char* const kFontCandidates[] = {
+    "assets/overlay_font.ttf",
+    "/System/Library/Fonts/Menlo.ttc",
+    "/System/Library/Fonts/Monaco.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+    "/usr/share/fonts/dejavu/DejaVuSansMono.ttf",
+    "C:/Windows/Fonts/consola.ttf",
+};
+}
+
+ProfilerOverlay::ProfilerOverlay() {
+    for (const char* path : kFontCandidates) {
+        if (font.openFromFile(path)) {
+            fontLoaded = true;
+            break;
+        }
+    }
+    if (fontLoaded) {
+        text.emplace(font, "", 14);
+        text->setFillColor(sf::Color::White);
+        text->setPosition({10.f, 10.f});
+    }
+    background.setFillColor(sf::Color(0, 0, 0, 170));
+    background.setPosition({4.f, 4.f});
+}
+
+void ProfilerOverlay::toggle() {
+    visible = !visible;
+    if (visible) {
+        if (!PROFILING_ENABLED) {
+            std::cout << "Instrumentación desactivada en esta compilación (compila con PROFILING=1)." << std::endl;
+        } else if (!fontLoaded) {
+            std::cout << "No se encontró una fuente para el overlay; el perfil se mostrará en la consola." << std::endl;
+        }
+        refresh();
+    }
+}
+
+void ProfilerOverlay::refresh() {
+    refreshClock.restart();
+    std::string summary;
+    for (const std::string& line : StageProfiler::instance().summaryLines()) {
+        summary += line;
+        summary += '\n';
+    }
+    if (statusSource) {
+        summary += statusSource();
+    }
+    if (!fontLoaded) {
+        std::cout << summary << std::flush;
+        return;
+    }
+    text->setString(summary);
+    sf::FloatRect bounds = text->getLocalBounds();
+    background.setSize({bounds.size.x + 16.f, bounds.size.y + 16.f});
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target) {
+    if (!visible) {
+        return;
+    }
+    if (refreshClock.getElapsedTime().asSeconds() >= (fontLoaded ? kRefreshSeconds : kConsoleRefreshSeconds)) {
+        refresh();
+    }
+    if (fontLoaded) {
+        // El overlay se dibuja en coordenadas de pantalla, sin la vista de la escena.
+        sf::View sceneView = target.getView();
+        target.setView(target.getDefaultView());
+        target.draw(background);
+        target.draw(*text);
+        target.setView(sceneView);
+    }
+}
@@ -0,0 +1,346 @@
+#include "silhouette_detector.hpp"
+#include "stage_profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+// Vecinos en el orden circular p2..p9 de Zhang-Suen: N, NE, E, SE, S, SO, O, NO.
+constexpr int kRingX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+constexpr int kRingY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+}
+
+void SilhouetteDetector::reset() {
+    learnedFrames = 0;
+}
+
+void SilhouetteDetector::detect(const cv::Mat& frame, DetectedPose& pose) {
+    PROFILE_STAGE(Detection);
+    pose.clear();
+    const int scale = std::max(1, workScale);
+    const cv::Size workSize(std::max(1, frame.cols / scale), std::max(1, frame.rows / scale));
+    cv::resize(frame, small, workSize, 0, 0, cv::INTER_AREA);
+
+    if (background.size() != workSize) {
+        learnedFrames = 0;
+    }
+    if (learnedFrames < learningFrames) {
+        // Media de los primeros frames, con la escena vacía. El primero inicializa el modelo:
+        // accumulateWeighted con peso 1 conservaría un NaN del buffer sin inicializar.
+        if (learnedFrames == 0) {
+            small.convertTo(background, CV_32F);
+        } else {
+            cv::accumulateWeighted(small, background, 1.0 / (learnedFrames + 1));
+        }
+        ++learnedFrames;
+        return;
+    }
+
+    subtractBackground();
+    morphology.erode(foreground, 3, 1);  // Apertura: quita el ruido aislado
+    morphology.dilate(foreground, 3, 2); // Cierre: une partes separadas por el umbral
+    morphology.erode(foreground, 3, 1);
+
+    cv::Rect bounds;
+    const int area = extractSilhouette(bounds);
+    if (area < minSilhouetteFraction * workSize.area()) {
+        return; // No hay nadie (o es ruido)
+    }
+
+    // Centro del torso: el punto de la silueta más alejado de su borde.
+    cv::distanceTransform(silhouetteMask, distance, cv::DIST_L2, 3);
+    double torsoRadius = 0.0;
+    cv::Point torso;
+    cv::minMaxLoc(distance, nullptr, &torsoRadius, nullptr, &torso);
+
+    thin();
+    findExtremities();
+
+    // Reparto de las extremidades respecto del torso (coordenadas del nivel reducido; el
+    // esqueleto tiene un borde de un pixel, de ahí el -1 al leer las puntas).
+    const double minBranch = minBranchFraction * bounds.height;
+    const float sx = static_cast<float>(frame.cols) / static_cast<float>(workSize.width);
+    const float sy = static_cast<float>(frame.rows) / static_cast<float>(workSize.height);
+    auto emit = [&](JointID joint, const Extremity& e) {
+        float confidence = static_cast<float>(std::min(1.0, e.length / (2.0 * minBranch)));
+        pose.set(joint, sf::Vector2f((static_cast<float>(e.tip.x - 1) + 0.5f) * sx, (static_cast<float>(e.tip.y - 1) + 0.5f) * sy),
+                 confidence);
+    };
+    extremities.erase(std::remove_if(extremities.begin(), extremities.end(), [&](const Extremity& e) {
+        double dx = e.tip.x - 1 - torso.x, dy = e.tip.y - 1 - torso.y;
+        return e.length < minBranch || dx * dx + dy * dy <= torsoRadius * torsoRadius;
+    }), extremities.end());
+
+    // Cabeza: la extremidad por encima del torso más cercana a la vertical (a menos de ~35°).
+    Extremity* head = nullptr;
+    double headSlope = 0.7;
+    for (Extremity& e : extremities) {
+        double dx = e.tip.x - 1 - torso.x, dy = e.tip.y - 1 - torso.y;
+        if (dy < -torsoRadius && std::abs(dx) < headSlope * -dy) {
+            headSlope = std::abs(dx) / -dy;
+            head = &e;
+        }
+    }
+    if (head) {
+        head->used = true;
+        emit(JointID::HEAD, *head);
+    }
+
+    // Pies: las dos extremidades más bajas dentro del tercio inferior de la silueta.
+    const int feetLine = bounds.y + 2 * bounds.height / 3;
+    Extremity* feet[2] = {nullptr, nullptr};
+    for (Extremity& e : extremities) {
+        if (e.used || e.tip.y - 1 < feetLine) continue;
+        if (!feet[0] || e.tip.y > feet[0]->tip.y) {
+            feet[1] = feet[0];
+            feet[0] = &e;
+        } else if (!feet[1] || e.tip.y > feet[1]->tip.y) {
+            feet[1] = &e;
+        }
+    }
+    // Manos: de las restantes, las dos más alejadas del torso.
+    Extremity* hands[2] = {nullptr, nullptr};
+    double handDistance[2] = {0.0, 0.0};
+    for (Extremity& e : extremities) {
+        if (e.used || &e == feet[0] || &e == feet[1]) continue;
+        double dx = e.tip.x - 1 - torso.x, dy = e.tip.y - 1 - torso.y;
+        double d = dx * dx + dy * dy;
+        if (!hands[0] || d > handDistance[0]) {
+            hands[1] = hands[0];
+            handDistance[1] = handDistance[0];
+            hands[0] = &e;
+            handDistance[0] = d;
+        } else if (!hands[1] || d > handDistance[1]) {
+            hands[1] = &e;
+            handDistance[1] = d;
+        }
+    }
+
+    // Lado: con dos, el de menor x es el izquierdo (frame espejado); con uno, según el torso.
+    auto emitPair = [&](Extremity* pair[2], JointID left, JointID right) {
+        if (pair[0] && pair[1]) {
+            bool firstIsLeft = pair[0]->tip.x < pair[1]->tip.x;
+            emit(left, *pair[firstIsLeft ? 0 : 1]);
+            emit(right, *pair[firstIsLeft ? 1 : 0]);
+        } else if (pair[0]) {
+            emit(pair[0]->tip.x - 1 < torso.x ? left : right, *pair[0]);
+        }
+    };
+    emitPair(feet, JointID::L_ANKLE, JointID::R_ANKLE);
+    emitPair(hands, JointID::L_WRIST, JointID::R_WRIST);
+}
+
+void SilhouetteDetector::subtractBackground() {
+    foreground.create(small.size(), CV_8UC1);
+    const float threshold = static_cast<float>(foregroundThreshold);
+    for (int y = 0; y < small.rows; ++y) {
+        const std::uint8_t* pixel = small.ptr<std::uint8_t>(y);
+        float* model = background.ptr<float>(y);
+        std::uint8_t* out = foreground.ptr<std::uint8_t>(y);
+        for (int x = 0; x < small.cols; ++x, pixel += 3, model += 3) {
+            float diff = std::abs(pixel[0] - model[0]) + std::abs(pixel[1] - model[1]) + std::abs(pixel[2] - model[2]);
+            bool isForeground = diff > threshold;
+            out[x] = isForeground ? 255 : 0;
+            if (!isForeground) {
+                // El fondo sigue los cambios lentos de luz; la persona no se incorpora.
+                for (int c = 0; c < 3; ++c) {
+                    model[c] += backgroundRate * (pixel[c] - model[c]);
+                }
+            }
+        }
+    }
+}
+
+int SilhouetteDetector::extractSilhouette(cv::Rect& bounds) {
+    const int w = foreground.cols, h = foreground.rows;
+    component.assign(static_cast<std::size_t>(w) * h, -1);
+
+    // Componentes 8-conexas del primer plano; cada una se identifica por su primer pixel.
+    int best = -1, bestCount = 0;
+    for (int start = 0; start < w * h; ++start) {
+        if (component[start] >= 0 || foreground.ptr<std::uint8_t>(start / w)[start % w] == 0) {
+            continue;
+        }
+        int count = 0;
+        component[start] = start;
+        stack.assign(1, start);
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            ++count;
+            int x = i % w, y = i / w;
+            for (int k = 0; k < 8; ++k) {
+                int nx = x + kRingX[k], ny = y + kRingY[k];
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                int n = ny * w + nx;
+                if (component[n] < 0 && foreground.ptr<std::uint8_t>(ny)[nx] != 0) {
+                    component[n] = start;
+                    stack.push_back(n);
+                }
+            }
+        }
+        if (count > bestCount) {
+            bestCount = count;
+            best = start;
+        }
+    }
+    if (best < 0) {
+        return 0;
+    }
+
+    // 255 = silueta, 0 = resto; después 1 = fondo alcanzable desde el borde (4-conexo).
+    silhouetteMask.create(foreground.size(), CV_8UC1);
+    int minX = w, minY = h, maxX = -1, maxY = -1;
+    for (int y = 0; y < h; ++y) {
+        std::uint8_t* row = silhouetteMask.ptr<std::uint8_t>(y);
+        for (int x = 0; x < w; ++x) {
+            bool inside = component[static_cast<std::size_t>(y) * w + x] == best;
+            row[x] = inside ? 255 : 0;
+            if (inside) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+    bounds = cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+
+    stack.clear();
+    auto seed = [&](int x, int y) {
+        std::uint8_t& value = silhouetteMask.ptr<std::uint8_t>(y)[x];
+        if (value == 0) {
+            value = 1;
+            stack.push_back(y * w + x);
+        }
+    };
+    for (int x = 0; x < w; ++x) {
+        seed(x, 0);
+        seed(x, h - 1);
+    }
+    for (int y = 0; y < h; ++y) {
+        seed(0, y);
+        seed(w - 1, y);
+    }
+    while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        int x = i % w, y = i / w;
+        if (x > 0) seed(x - 1, y);
+        if (x + 1 < w) seed(x + 1, y);
+        if (y > 0) seed(x, y - 1);
+        if (y + 1 < h) seed(x, y + 1);
+    }
+    int area = 0;
+    for (int y = 0; y < h; ++y) {
+        std::uint8_t* row = silhouetteMask.ptr<std::uint8_t>(y);
+        for (int x = 0; x < w; ++x) {
+            row[x] = row[x] == 1 ? 0 : 255; // Lo que el fondo exterior no alcanzó es un hueco
+            area += row[x] != 0;
+        }
+    }
+    return area;
+}
+
+// Adelgazamiento de Zhang-Suen: dos subiteraciones que borran los pixels del borde
+// (sureste y noroeste) que no desconectan la silueta ni acortan sus extremos, hasta que
+// no cambia nada.
+void SilhouetteDetector::thin() {
+    const int w = silhouetteMask.cols, h = silhouetteMask.rows;
+    skeleton.create(h + 2, w + 2, CV_8UC1);
+    skeleton.setTo(cv::Scalar::all(0));
+    for (int y = 0; y < h; ++y) {
+        const std::uint8_t* in = silhouetteMask.ptr<std::uint8_t>(y);
+        std::uint8_t* out = skeleton.ptr<std::uint8_t>(y + 1) + 1;
+        for (int x = 0; x < w; ++x) {
+            out[x] = in[x] != 0;
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int pass = 0; pass < 2; ++pass) {
+            deletions.clear();
+            for (int y = 1; y <= h; ++y) {
+                const std::uint8_t* up = skeleton.ptr<std::uint8_t>(y - 1);
+                const std::uint8_t* row = skeleton.ptr<std::uint8_t>(y);
+                const std::uint8_t* down = skeleton.ptr<std::uint8_t>(y + 1);
+                for (int x = 1; x <= w; ++x) {
+                    if (!row[x]) continue;
+                    const int p[8] = {up[x], up[x + 1], row[x + 1], down[x + 1], down[x], down[x - 1], row[x - 1], up[x - 1]};
+                    int neighbors = 0, transitions = 0;
+                    for (int k = 0; k < 8; ++k) {
+                        neighbors += p[k];
+                        transitions += !p[k] && p[(k + 1) & 7];
+                    }
+                    if (neighbors < 2 || neighbors > 6 || transitions != 1) continue;
+                    // p[0] = N, p[2] = E, p[4] = S, p[6] = O
+                    bool erase = pass == 0 ? !(p[0] && p[2] && p[4]) && !(p[2] && p[4] && p[6])
+                                           : !(p[0] && p[2] && p[6]) && !(p[0] && p[4] && p[6]);
+                    if (erase) {
+                        deletions.push_back(y * (w + 2) + x);
+                    }
+                }
+            }
+            for (int i : deletions) {
+                skeleton.ptr<std::uint8_t>(i / (w + 2))[i % (w + 2)] = 0;
+            }
+            changed = changed || !deletions.empty();
+        }
+    }
+}
+
+// Número de tramos del esqueleto que salen del pixel (transiciones 0 -> 1 alrededor):
+// 1 en un extremo, 2 en medio de una rama (también en los escalones diagonales) y 3 o
+// más en una bifurcación.
+int SilhouetteDetector::skeletonBranches(int x, int y) const {
+    int transitions = 0;
+    for (int k = 0; k < 8; ++k) {
+        bool current = skeleton.ptr<std::uint8_t>(y + kRingY[k])[x + kRingX[k]] != 0;
+        bool next = skeleton.ptr<std::uint8_t>(y + kRingY[(k + 1) & 7])[x + kRingX[(k + 1) & 7]] != 0;
+        transitions += !current && next;
+    }
+    return transitions;
+}
+
+void SilhouetteDetector::findExtremities() {
+    extremities.clear();
+    const int stride = skeleton.cols;
+    for (int y = 1; y < skeleton.rows - 1; ++y) {
+        for (int x = 1; x < skeleton.cols - 1; ++x) {
+            if (skeleton.ptr<std::uint8_t>(y)[x] != 1 || skeletonBranches(x, y) != 1) {
+                continue;
+            }
+            // Recorre la rama desde la punta hasta la primera bifurcación (o el otro extremo),
+            // marcando los pixels visitados con 2 y restaurándolos al final.
+            deletions.clear();
+            int cx = x, cy = y;
+            while (true) {
+                skeleton.ptr<std::uint8_t>(cy)[cx] = 2;
+                deletions.push_back(cy * stride + cx);
+                if (deletions.size() > 1 && skeletonBranches(cx, cy) >= 3) {
+                    break;
+                }
+                // Siguiente pixel sin visitar, primero los 4-vecinos (en los escalones hay dos candidatos).
+                int next = -1;
+                for (int k : {0, 2, 4, 6, 1, 3, 5, 7}) {
+                    int nx = cx + kRingX[k], ny = cy + kRingY[k];
+                    if (skeleton.ptr<std::uint8_t>(ny)[nx] == 1) {
+                        next = k;
+                        break;
+                    }
+                }
+                if (next < 0) {
+                    break;
+                }
+                cx += kRingX[next];
+                cy += kRingY[next];
+            }
+            for (int i : deletions) {
+                skeleton.ptr<std::uint8_t>(i / stride)[i % stride] = 1;
+            }
+            extremities.push_back({cv::Point(x, y), static_cast<int>(deletions.size()) - 1, false});
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#include "stage_profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+const char* profileStageName(ProfileStage stage) {
+    switch (stage) {
+        case ProfileStage::CameraRead: return "camera_read";
+        case ProfileStage::Detection: return "detection";
+        case ProfileStage::ColorClassify: return "color_classify";
+        case ProfileStage::Morphology: return "morphology";
+        case ProfileStage::BlobExtraction: return "blob_extraction";
+        case ProfileStage::CentroidRefine: return "centroid_refine";
+        case ProfileStage::PoseUpdate: return "pose_update";
+        case ProfileStage::Draw: return "draw";
+        case ProfileStage::Present: return "present";
+        case ProfileStage::CaptureToPresent: return "capture_to_present";
+        case ProfileStage::Count: break;
+    }
+    return "?";
+}
+
+// Los valores < 16 µs tienen un cubo cada uno; a partir de ahí cada potencia de 2 se
+// divide en kSubBuckets cubos iguales.
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t micros) {
+    if (micros < kSubBuckets) {
+        return static_cast<std::size_t>(micros);
+    }
+    int msb = 63 - __builtin_clzll(micros);
+    int shift = msb - 4;
+    std::size_t index = static_cast<std::size_t>(shift + 1) * kSubBuckets + ((micros >> shift) & (kSubBuckets - 1));
+    return std::min(index, kBucketCount - 1);
+}
+
+double LatencyHistogram::bucketMidpoint(std::size_t index) {
+    if (index < kSubBuckets) {
+        return static_cast<double>(index);
+    }
+    std::size_t shift = index / kSubBuckets - 1;
+    std::uint64_t lower = static_cast<std::uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+    return static_cast<double>(lower) + static_cast<double>(std::uint64_t{1} << shift) * 0.5;
+}
+
+void LatencyHistogram::record(std::uint64_t micros) {
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t previous = maximum.load(std::memory_order_relaxed);
+    while (micros > previous && !maximum.compare_exchange_weak(previous, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::percentile(double p) const {
+    // Se toma una copia de los cubos; como los escritores siguen activos, la suma puede
+    // diferir ligeramente de total, así que se usa la de la copia.
+    std::array<std::uint32_t, kBucketCount> snapshot;
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        snapshot[i] = buckets[i].load(std::memory_order_relaxed);
+        sum += snapshot[i];
+    }
+    if (sum == 0) {
+        return 0.0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sum - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += snapshot[i];
+        if (seen >= rank) {
+            return bucketMidpoint(i);
+        }
+    }
+    return bucketMidpoint(kBucketCount - 1);
+}
+
+StageProfiler& StageProfiler::instance() {
+    static StageProfiler profiler;
+    return profiler;
+}
+
+void StageProfiler::record(ProfileStage stage, std::chrono::steady_clock::duration elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    histograms[static_cast<std::size_t>(stage)].record(static_cast<std::uint64_t>(std::max<std::int64_t>(micros, 0)));
+}
+
+void StageProfiler::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+}
+
+std::vector<std::string> StageProfiler::summaryLines() const {
+    std::vector<std::string> lines;
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%-18s %7s %7s %7s %7s %8s", "etapa (ms)", "p50", "p95", "p99", "max", "n");
+    lines.emplace_back(buffer);
+    for (std::size_t i = 0; i < kProfileStageCount; ++i) {
+        const LatencyHistogram& h = histograms[i];
+        if (h.count() == 0) {
+            continue;
+        }
+        std::snprintf(buffer, sizeof(buffer), "%-18s %7.2f %7.2f %7.2f %7.2f %8llu",
+                      profileStageName(static_cast<ProfileStage>(i)),
+                      h.percentile(50) / 1000.0, h.percentile(95) / 1000.0, h.percentile(99) / 1000.0,
+                      h.maxMicros() / 1000.0, static_cast<unsigned long long>(h.count()));
+        lines.emplace_back(buffer);
+    }
+    return lines;
+}
+
+bool StageProfiler::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "ERROR: No se pudo escribir el perfil en " << path << std::endl;
+        return false;
+    }
+    out << "stage,count,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (std::size_t i = 0; i < kProfileStageCount; ++i) {
+        const LatencyHistogram& h = histograms[i];
+        out << profileStageName(static_cast<ProfileStage>(i)) << ',' << h.count() << ','
+            << h.percentile(50) / 1000.0 << ',' << h.percentile(95) / 1000.0 << ','
+            << h.percentile(99) / 1000.0 << ',' << h.maxMicros() / 1000.0 << '\n';
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+#include "video_exporter.hpp"
+#include "animation_mixer.hpp"
+#include "async_video_encoder.hpp"
+#include "demo_animation.hpp"
+#include "pose_track.hpp"
+#include "stick_figure.hpp"
+#include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+VideoExporter::VideoExporter(const ExportOptions& options) : options(options) {}
+
+bool VideoExporter::run() {
+    result = Stats{};
+    // Fuente de poses: la pista grabada (remuestreada a `fps` según sus timestamps, porque
+    // se grabó a la frecuencia variable de la detección) o el clip de saludo de la demo.
+    PoseTrackReader track;
+    DemoClips demoClips;
+    AnimationMixer mixer;
+    const double fps = options.fps;
+    std::uint64_t frameCount = 0;
+    if (!options.trackPath.empty()) {
+        if (!track.open(options.trackPath) || track.frameCount() == 0) {
+            std::cerr << "ERROR: No se pudo leer la pista de pose " << options.trackPath << std::endl;
+            return false;
+        }
+        frameCount = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(track.duration() * fps));
+    } else {
+        demoClips = loadDemoClips();
+        mixer.crossfadeTo(&demoClips.wave, 0.f);
+        frameCount = static_cast<std::uint64_t>(options.demoSeconds * fps);
+    }
+
+    const sf::Vector2u size(options.width, options.height);
+    sf::RenderTexture target;
+    if (!target.resize(size)) {
+        std::cerr << "ERROR: No se pudo crear el destino offscreen de " << size.x << "x" << size.y
+                  << " (se necesita un contexto OpenGL; sin pantalla, usa xvfb-run)." << std::endl;
+        return false;
+    }
+    AsyncVideoEncoder encoder;
+    if (!encoder.open(options.outputPath, cv::Size(static_cast<int>(size.x), static_cast<int>(size.y)), fps, options.buffers)) {
+        return false;
+    }
+
+    // Vista con el eje y invertido: la imagen queda en el destino con la primera fila arriba
+    // en memoria, así glReadPixels la deja en el orden de filas de cv::Mat sin darle la vuelta.
+    sf::View flipped(sf::FloatRect{{0.f, 0.f}, {static_cast<float>(size.x), static_cast<float>(size.y)}});
+    flipped.setSize({static_cast<float>(size.x), -static_cast<float>(size.y)});
+    target.setView(flipped);
+
+    StickFigure figure;
+    figure.initialize(size);
+    const sf::Vector2f center(static_cast<float>(size.x) / 2.f, static_cast<float>(size.y) / 2.f);
+    DetectedPose pose;
+    double renderSeconds = 0.0;
+
+    std::cout << "Exportando " << frameCount << " frames (" << size.x << "x" << size.y << ", " << fps << " fps) a "
+              << options.outputPath << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < frameCount; ++i) {
+        auto renderStart = std::chrono::steady_clock::now();
+        if (track.isOpen()) {
+            figure.updatePose(track.frame(track.frameIndexAt(static_cast<double>(i) / fps)).pose);
+        } else {
+            mixer.evaluate(center, 1.f, pose);
+            figure.updatePose(pose);
+            mixer.update(static_cast<float>(1.0 / fps));
+        }
+        target.clear(sf::Color(220, 220, 220));
+        figure.draw(target);
+        target.display();
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+
+        // Si el codificador va atrasado, aquí se espera a que libere un buffer. Los pixels se
+        // leen de la GPU directamente en él: sin sf::Image intermedia ni copia por frame.
+        cv::Mat& buffer = encoder.acquire();
+        auto readStart = std::chrono::steady_clock::now();
+        if (!target.setActive(true)) {
+            std::cerr << "ERROR: No se pudo activar el contexto OpenGL del destino offscreen." << std::endl;
+            encoder.finish();
+            return false;
+        }
+        glReadPixels(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), GL_RGBA, GL_UNSIGNED_BYTE, buffer.data);
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+        encoder.submit();
+    }
+    encoder.finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    AsyncVideoEncoder::Stats stats = encoder.stats();
+    const double frames = static_cast<double>(stats.framesWritten);
+    result.frames = stats.framesWritten;
+    result.seconds = seconds;
+    result.framesPerSecond = seconds > 0.0 ? frames / seconds : 0.0;
+    result.realtimeFactor = seconds > 0.0 ? frames / fps / seconds : 0.0;
+    result.renderFps = renderSeconds > 0.0 ? frames / renderSeconds : 0.0;
+    result.encodeFps = stats.encodeSeconds > 0.0 ? frames / stats.encodeSeconds : 0.0;
+    result.producerWaits = stats.producerWaits;
+    std::cout << result.frames << " frames (" << frames / fps << " s de video) exportados en " << seconds << " s: "
+              << result.framesPerSecond << " fps, " << result.realtimeFactor << "x tiempo real." << std::endl;
+    std::cout << "  Render: " << result.renderFps << " fps, codificación: " << result.encodeFps
+              << " fps, esperas del render por un buffer libre: " << result.producerWaits << std::endl;
+    return true;
+}
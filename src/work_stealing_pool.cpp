@@ -0,0 +1,131 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+namespace {
+// Hilo del grupo que está ejecutando el código actual (nullptr fuera de cualquier grupo).
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+}
+
+void WorkStealingPool::Queue::push(Task&& task) {
+    if (count == ring.size()) {
+        // Crecer y desenrollar: el elemento head pasa a la posición 0.
+        std::vector<Task> larger(std::max<std::size_t>(8, ring.size() * 2));
+        for (std::size_t i = 0; i < count; ++i) {
+            larger[i] = std::move(ring[(head + i) % ring.size()]);
+        }
+        ring.swap(larger);
+        head = 0;
+    }
+    ring[(head + count) % ring.size()] = std::move(task);
+    ++count;
+}
+
+bool WorkStealingPool::Queue::popFront(Task& task) {
+    if (count == 0) {
+        return false;
+    }
+    task = std::move(ring[head]);
+    ring[head] = nullptr;
+    head = (head + 1) % ring.size();
+    --count;
+    return true;
+}
+
+bool WorkStealingPool::Queue::popBack(Task& task) {
+    if (count == 0) {
+        return false;
+    }
+    std::size_t last = (head + count - 1) % ring.size();
+    task = std::move(ring[last]);
+    ring[last] = nullptr;
+    --count;
+    return true;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, static_cast<std::size_t>(i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    std::size_t target = currentPool == this
+        ? currentWorker
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->push(std::move(task));
+    }
+    {
+        // Bajo el mutex de espera, para que un hilo que está por dormirse vea la tarea.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::takeTask(std::size_t index, Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (queues[index]->popFront(task)) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // Robar del final de las otras colas (la tarea encolada más recientemente).
+    for (std::size_t k = 1; k < queues.size(); ++k) {
+        Queue& victim = *queues[(index + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.popBack(task)) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    Task task;
+    while (true) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr;
+            executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+        // Al destruir el grupo se terminan primero las tareas que quedan en las colas.
+        if (stopping && pending.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+WorkStealingPool::Stats WorkStealingPool::stats() const {
+    Stats s;
+    s.executed = executed.load(std::memory_order_relaxed);
+    s.stolen = stolen.load(std::memory_order_relaxed);
+    return s;
+}